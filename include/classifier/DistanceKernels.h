@@ -0,0 +1,134 @@
+#ifndef DISTANCEKERNELS_H
+#define DISTANCEKERNELS_H
+
+#include <cstddef>
+
+/**
+ * Noyaux de distance entre deux vecteurs de descripteurs (double ou float).
+ *
+ * Chaque noyau existe en version scalaire (référence) et en versions SSE2, AVX2 et AVX-512.
+ * Le jeu d'instructions est détecté au premier appel et peut être forcé avec `setInstructionSet`.
+ * Pour chaque jeu d'instructions, les dimensions des représentations connues (18, 29, 36, 100)
+ * ont une version spécialisée que le compilateur déroule entièrement.
+ *
+ * Toutes les versions additionnent les termes dans le même ordre : le terme i est ajouté à
+ * l'accumulateur i % L (L = 16 en double, 32 en float, soit `kAccumulatorBytes` octets), puis
+ * les accumulateurs sont sommés deux à deux par moitiés. Le résultat est donc identique au bit
+ * près quel que soit le jeu d'instructions utilisé.
+ */
+class DistanceKernels {
+public:
+    enum class InstructionSet { Scalar, SSE2, AVX2, AVX512 };
+
+    // Taille totale des accumulateurs : 2 registres AVX-512, 4 AVX2 ou 8 SSE2, assez pour
+    // masquer la latence des additions.
+    static constexpr std::size_t kAccumulatorBytes = 128;
+
+    /**
+     * Pointeur vers un noyau : (a, b, taille) -> distance.
+     */
+    using Kernel = double (*)(const double* a, const double* b, std::size_t size);
+    using FloatKernel = double (*)(const float* a, const float* b, std::size_t size);
+
+    /**
+     * Versions scalaires de référence (distance euclidienne au carré et distance de Manhattan).
+     */
+    static double squaredEuclidean(const double* a, const double* b, std::size_t size);
+    static double squaredEuclidean(const float* a, const float* b, std::size_t size);
+    static double manhattan(const double* a, const double* b, std::size_t size);
+    static double manhattan(const float* a, const float* b, std::size_t size);
+
+    /**
+     * Choisit le noyau euclidien au carré adapté à une dimension.
+     * Entrée :
+     *   - dimension (size_t) : Nombre de descripteurs.
+     *   - isa (InstructionSet) : Jeu d'instructions voulu (par défaut celui actif) ; s'il n'est pas
+     *     supporté par le processeur, le jeu d'instructions actif est utilisé.
+     * Sortie (Kernel) : Version spécialisée si la dimension est celle d'une représentation connue,
+     *   version générique sinon.
+     */
+    static Kernel squaredEuclideanKernel(std::size_t dimension);
+    static Kernel squaredEuclideanKernel(std::size_t dimension, InstructionSet isa);
+
+    /**
+     * Choisit le noyau de Manhattan adapté à une dimension (même règle que `squaredEuclideanKernel`).
+     */
+    static Kernel manhattanKernel(std::size_t dimension);
+    static Kernel manhattanKernel(std::size_t dimension, InstructionSet isa);
+
+    /**
+     * Équivalents pour des descripteurs stockés en float (ex. `DescriptorStore` en Float32).
+     * Les sommes sont faites en float.
+     */
+    static FloatKernel squaredEuclideanFloatKernel(std::size_t dimension);
+    static FloatKernel squaredEuclideanFloatKernel(std::size_t dimension, InstructionSet isa);
+    static FloatKernel manhattanFloatKernel(std::size_t dimension);
+    static FloatKernel manhattanFloatKernel(std::size_t dimension, InstructionSet isa);
+
+    /**
+     * Largeur (en lignes d'entraînement) d'un panneau pour `dotPanelKernel`.
+     */
+    static constexpr std::size_t kPanelWidth = 16;
+
+    /**
+     * Micro-noyau de produits scalaires requêtes x panneau :
+     *   out[i * outStride + j] = queries[i] . colonne j du panneau, pour i < rows et j < kPanelWidth.
+     * Le panneau contient kPanelWidth lignes d'entraînement stockées dimension par dimension
+     * (`panel[d * kPanelWidth + j]`), complétées par des zéros.
+     * Les produits d'un bloc de requêtes sont gardés dans des registres pendant tout le parcours
+     * des dimensions (blocage par registres, comme dans un GEMM).
+     */
+    using DotPanelKernel = void (*)(const double* queries, std::size_t queryStride, std::size_t rows,
+                                    const double* panel, std::size_t dimension, double* out, std::size_t outStride);
+
+    static DotPanelKernel dotPanelKernel();
+    static DotPanelKernel dotPanelKernel(InstructionSet isa);
+
+    /**
+     * Nombre de dimensions entre deux tests d'abandon de `squaredEuclideanPanelKernel` et
+     * `manhattanPanelKernel`.
+     */
+    static constexpr std::size_t kPanelCheckInterval = 8;
+
+    /**
+     * Distances d'une requête aux kPanelWidth lignes d'un panneau (même disposition que pour
+     * `dotPanelKernel`), avec abandon anticipé : toutes les `kPanelCheckInterval` dimensions, le
+     * calcul s'arrête si les kPanelWidth sommes partielles dépassent toutes `bound`.
+     * out[j] reçoit la somme, partielle ou complète, de la ligne j ; les termes étant positifs, une
+     * somme partielle ne dépasse jamais la somme complète. Les termes sont ajoutés dimension par
+     * dimension, dans un autre ordre que les noyaux par ligne : le résultat peut en différer de
+     * quelques ulps et sert à rejeter des lignes, pas à les classer.
+     */
+    using BoundedPanelKernel = void (*)(const double* query, const double* panel, std::size_t dimension,
+                                        double bound, double* out);
+
+    static BoundedPanelKernel squaredEuclideanPanelKernel();
+    static BoundedPanelKernel squaredEuclideanPanelKernel(InstructionSet isa);
+    static BoundedPanelKernel manhattanPanelKernel();
+    static BoundedPanelKernel manhattanPanelKernel(InstructionSet isa);
+
+    /**
+     * Jeu d'instructions le plus large supporté par le processeur.
+     */
+    static InstructionSet detectInstructionSet();
+
+    /**
+     * Jeu d'instructions utilisé par les sélecteurs sans argument `isa`.
+     */
+    static InstructionSet activeInstructionSet();
+
+    /**
+     * Force le jeu d'instructions utilisé par les sélecteurs sans argument `isa`.
+     * Entrée :
+     *   - isa (InstructionSet) : Jeu d'instructions voulu.
+     * Sortie (bool) :
+     *   - true si le processeur le supporte.
+     *   - false sinon (le jeu d'instructions actif est inchangé).
+     */
+    static bool setInstructionSet(InstructionSet isa);
+
+    static bool isSupported(InstructionSet isa);
+    static const char* instructionSetName(InstructionSet isa);
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef DISTANCEPOLICY_H
+#define DISTANCEPOLICY_H
+
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include "classifier/DistanceKernels.h"
+
+enum class DistanceMetric { Euclidean, Manhattan };
+
+/**
+ * Convertit un nom de distance ("euclidean", "manhattan") en `DistanceMetric`.
+ * Entrée :
+ *   - name (std::string) : Nom de la distance.
+ * Sortie (DistanceMetric) : Distance correspondante.
+ * Lève `std::invalid_argument` si le nom n'est pas reconnu.
+ */
+DistanceMetric distanceMetricFromName(const std::string& name);
+
+const char* distanceMetricName(DistanceMetric metric);
+
+/**
+ * Distance choisie une fois pour toutes (à la construction d'un classifieur) : le noyau est
+ * résolu pour la dimension du dataset et n'est plus comparé à une chaîne à chaque paire.
+ *
+ * Les comparaisons se font sur une distance de classement (`rank`) croissante avec la vraie
+ * distance : la distance euclidienne au carré, ou la distance de Manhattan elle-même.
+ * `finalize` convertit une distance de classement en vraie distance (racine carrée pour
+ * l'euclidienne) ; on ne l'applique qu'aux voisins retenus.
+ */
+class DistancePolicy {
+public:
+    DistancePolicy();
+
+    /**
+     * Entrée :
+     *   - metric (DistanceMetric) : Distance utilisée.
+     *   - dimension (size_t) : Nombre de descripteurs des vecteurs comparés.
+     * Sortie : Une politique dont le noyau est spécialisé sur `dimension`.
+     */
+    DistancePolicy(DistanceMetric metric, std::size_t dimension);
+
+    DistanceMetric metric() const { return distanceMetric; }
+    std::size_t dimension() const { return dim; }
+
+    /**
+     * Distance de classement entre deux vecteurs de `dimension()` descripteurs.
+     */
+    double rank(const double* a, const double* b) const { return kernel(a, b, dim); }
+
+    /**
+     * Convertit une distance de classement en vraie distance.
+     */
+    double finalize(double rankDistance) const {
+        return distanceMetric == DistanceMetric::Euclidean ? std::sqrt(rankDistance) : rankDistance;
+    }
+
+    /**
+     * Vraie distance entre deux vecteurs de `size` descripteurs (`size` peut différer de `dimension()`).
+     */
+    double distance(const double* a, const double* b, std::size_t size) const;
+
+    DistanceKernels::Kernel rankKernel() const { return kernel; }
+
+private:
+    DistanceMetric distanceMetric;
+    std::size_t dim;
+    DistanceKernels::Kernel kernel;
+
+    static DistanceKernels::Kernel resolve(DistanceMetric metric, std::size_t dimension);
+};
+
+#endif
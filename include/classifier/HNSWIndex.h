@@ -0,0 +1,97 @@
+#ifndef HNSWINDEX_H
+#define HNSWINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "classifier/NeighborIndex.h"
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Paramètres du graphe HNSW.
+ */
+struct HNSWParameters {
+    std::size_t M = 16;                // Voisins par nœud et par niveau (2M au niveau 0).
+    std::size_t efConstruction = 200;  // Largeur de la recherche pendant la construction.
+    std::size_t efSearch = 64;         // Largeur de la recherche d'une requête (au moins K).
+    std::size_t numThreads = 0;        // Threads de construction (0 = pool partagé ThreadPool::shared(), 1 = séquentiel).
+    unsigned seed = 42;                // Graine du tirage des niveaux.
+};
+
+/**
+ * Index approché HNSW (Malkov et Yashunin) pour les descripteurs de grande dimension (GFD).
+ *
+ * Chaque point reçoit un niveau tiré selon une loi géométrique ; il est relié à ses voisins sur
+ * chaque niveau jusqu'au sien, choisis par l'heuristique de diversité de l'article. Une requête
+ * descend gloutonnement les niveaux supérieurs puis explore le niveau 0 avec une file de taille
+ * `efSearch` : le coût est sous-linéaire mais le résultat n'est pas garanti exact (voir
+ * scripts/Bench_ann.cpp pour le rappel obtenu).
+ *
+ * Les listes de voisins sont stockées à plat : (nombre, voisins...) par nœud et par niveau.
+ * La construction insère les points en parallèle avec un verrou par groupe de nœuds ; avec
+ * plusieurs threads, le graphe dépend de l'ordre d'exécution. Avec `numThreads = 1`, il ne dépend
+ * que de `seed`.
+ */
+class HNSWIndex : public NeighborIndex {
+public:
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor).
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - parameters (HNSWParameters) : M, efConstruction, efSearch, threads et graine.
+     * Sortie : Un index construit sur `data`.
+     */
+    HNSWIndex(const FeatureMatrix& data, const DistancePolicy& policy,
+              const HNSWParameters& parameters = HNSWParameters());
+
+    /**
+     * Propose au sélecteur les max(efSearch, K) meilleurs candidats trouvés dans le graphe,
+     * avec leur distance de classement exacte.
+     */
+    void search(const double* query, TopKSelector& selector) const override;
+    const char* name() const override { return "HNSW"; }
+
+    /**
+     * Modifie la largeur de recherche sans reconstruire le graphe.
+     */
+    void setEfSearch(std::size_t ef) { parameters.efSearch = ef; }
+    std::size_t efSearch() const { return parameters.efSearch; }
+
+    std::size_t size() const { return points.rows(); }
+    int maxLevel() const { return topLevel; }
+
+private:
+    using Candidate = std::pair<double, std::uint32_t>;
+    struct Scratch;
+
+    DistancePolicy policy;
+    HNSWParameters parameters;
+    std::size_t maxLinks;                              // M
+    std::size_t maxBaseLinks;                          // 2M
+    FeatureMatrix points;
+    std::vector<int> levels;                           // Niveau de chaque nœud.
+    std::vector<std::uint32_t> baseLinks;              // Niveau 0 : n * (maxBaseLinks + 1).
+    std::vector<std::vector<std::uint32_t>> upperLinks; // Niveaux 1..levels[i] : levels[i] * (maxLinks + 1).
+    std::uint32_t entryPoint;
+    int topLevel;
+
+    mutable std::vector<std::mutex> nodeLocks;         // Verrous de construction (un par groupe de nœuds).
+    std::mutex entryMutex;                             // Protège entryPoint et topLevel pendant la construction.
+
+    double distance(const double* query, std::uint32_t node) const;
+    std::uint32_t* links(std::uint32_t node, int level);
+    const std::uint32_t* links(std::uint32_t node, int level) const;
+    const std::uint32_t* readLinks(std::uint32_t node, int level, bool locked, Scratch& scratch) const;
+
+    void insert(std::uint32_t node, Scratch& scratch);
+    std::uint32_t greedyDescent(const double* query, std::uint32_t start, int fromLevel, int toLevel,
+                                bool locked, Scratch& scratch) const;
+    void searchLayer(const double* query, std::uint32_t start, std::size_t ef, int level, bool locked,
+                     Scratch& scratch) const;
+    void selectNeighbors(std::vector<Candidate>& candidates, std::size_t limit) const;
+    void connect(std::uint32_t node, std::uint32_t neighbor, double neighborDistance, int level);
+};
+
+#endif
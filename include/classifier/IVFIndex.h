@@ -0,0 +1,72 @@
+#ifndef IVFINDEX_H
+#define IVFINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "classifier/NeighborIndex.h"
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Paramètres de l'index IVF.
+ */
+struct IVFParameters {
+    std::size_t lists = 0;           // Nombre de listes (centroids KMeans) ; 0 = racine carrée du nombre de lignes.
+    std::size_t nprobe = 8;          // Listes parcourues par requête.
+    int trainIterations = 20;        // Itérations de KMeans.
+    std::size_t trainingSample = 0;  // Lignes utilisées pour apprendre les centroids (0 = toutes).
+};
+
+/**
+ * Index à fichier inversé (IVF) : le dataset est partitionné selon le centroid `KMeans` le plus
+ * proche de chaque ligne, et chaque partition (liste) est stockée de façon contiguë.
+ *
+ * Une requête classe les centroids par distance et ne parcourt, avec le noyau exact, que les
+ * `nprobe` listes les plus proches. Le résultat est approché ; avec nprobe = nombre de listes,
+ * il est identique à la recherche exhaustive.
+ *
+ * Les centroids `KMeans` minimisent la distance euclidienne au carré : l'affectation des lignes aux
+ * listes et le choix des listes à parcourir utilisent donc toujours la distance euclidienne, même
+ * si `policy` est Manhattan. Seul le parcours des listes utilise la distance de `policy`.
+ */
+class IVFIndex : public NeighborIndex {
+public:
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor).
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - parameters (IVFParameters) : Nombre de listes, nprobe et apprentissage des centroids.
+     * Sortie : Un index dont les centroids sont appris par `KMeans` sur `data`.
+     */
+    IVFIndex(const FeatureMatrix& data, const DistancePolicy& policy, const IVFParameters& parameters = IVFParameters());
+
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor).
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - centroids (FeatureMatrix&) : Centroids déjà appris (ex. `KMeans::getCentroids`), de la dimension de `data`.
+     *   - nprobe (size_t) : Listes parcourues par requête.
+     * Sortie : Un index partitionné selon `centroids`.
+     */
+    IVFIndex(const FeatureMatrix& data, const DistancePolicy& policy, const FeatureMatrix& centroids, std::size_t nprobe);
+
+    void search(const double* query, TopKSelector& selector) const override;
+    const char* name() const override { return "IVF"; }
+
+    void setNprobe(std::size_t value) { nprobe = value; }
+    std::size_t probes() const { return nprobe; }
+    std::size_t listCount() const { return centroids.rows(); }
+
+private:
+    DistancePolicy policy;                 // Distance des voisins (parcours des listes).
+    DistancePolicy quantizer;              // Distance euclidienne aux centroids (affectation et choix des listes).
+    std::size_t nprobe;
+    FeatureMatrix centroids;
+    FeatureMatrix points;                  // Lignes rangées liste par liste.
+    std::vector<std::size_t> listBegin;    // Liste c : lignes [listBegin[c], listBegin[c + 1]).
+
+    void partition(const FeatureMatrix& data);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef KDTREEINDEX_H
+#define KDTREEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "classifier/NeighborIndex.h"
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * KD-tree exact pour les descripteurs de petite dimension.
+ *
+ * Construction par « sliding midpoint » : chaque cellule est coupée au milieu de son plus grand
+ * côté ; si tous les points tombent d'un côté, le plan glisse jusqu'au point le plus proche pour
+ * qu'aucune feuille ne soit vide. Les nœuds sont stockés dans un tableau plat et les lignes sont
+ * recopiées dans l'ordre des feuilles pour être lues de façon contiguë.
+ *
+ * La recherche calcule incrémentalement la distance de la requête à chaque cellule (Arya et Mount)
+ * et élague une cellule plus loin que le K-ième voisin courant. Les points sont comparés avec le
+ * noyau exact de la `DistancePolicy` : le résultat est identique à la recherche exhaustive,
+ * en distance euclidienne comme en distance de Manhattan.
+ */
+class KDTreeIndex : public NeighborIndex {
+public:
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor).
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - leafSize (size_t) : Nombre maximal de points par feuille.
+     * Sortie : Un index construit sur `data`.
+     */
+    KDTreeIndex(const FeatureMatrix& data, const DistancePolicy& policy, std::size_t leafSize = 16);
+
+    void search(const double* query, TopKSelector& selector) const override;
+    const char* name() const override { return "KD-tree"; }
+
+    std::size_t nodeCount() const { return nodes.size(); }
+    std::size_t depth() const { return treeDepth; }
+
+private:
+    struct Node {
+        std::uint32_t begin;      // Première ligne de la feuille (dans `points`).
+        std::uint32_t end;
+        std::int32_t left;        // -1 pour une feuille.
+        std::int32_t right;
+        std::uint32_t splitDimension;
+        double splitValue;
+    };
+
+    DistancePolicy policy;
+    std::size_t leafSize;
+    std::size_t treeDepth;
+    std::vector<Node> nodes;
+    FeatureMatrix points;                // Lignes dans l'ordre des feuilles.
+    std::vector<double> rootLower;       // Cellule racine (boîte englobante des points).
+    std::vector<double> rootUpper;
+
+    std::int32_t build(std::vector<std::uint32_t>& order, const FeatureMatrix& data, std::uint32_t begin, std::uint32_t end,
+                       std::vector<double>& lower, std::vector<double>& upper, std::size_t level);
+
+    template <DistanceMetric Metric>
+    void searchNode(std::int32_t nodeIndex, const double* query, double cellDistance, double* offsets,
+                    TopKSelector& selector) const;
+
+    template <DistanceMetric Metric>
+    void searchFrom(const double* query, TopKSelector& selector) const;
+};
+
+#endif
@@ -4,8 +4,58 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <cstddef>
+#include <cstdint>
 #include "dataRepo/Image.h"
-#include <unordered_map>
+#include "dataRepo/FeatureMatrix.h"
+#include "parallel/ThreadPool.h"
+#include <array>
+#include <map>
+#include <memory>
+
+/**
+ * Options d'entraînement de `KMeans`.
+ */
+struct KMeansOptions {
+    enum class Init {
+        Auto,            // k-means++ jusqu'à kParallelInitRows lignes, k-means|| au-delà.
+        Random,          // numClusters lignes tirées uniformément (avec remise).
+        KMeansPlusPlus,  // k-means++ glouton (Arthur & Vassilvitskii).
+        KMeansParallel   // k-means|| (Bahmani et al.) : suréchantillonnage en quelques passes parallèles.
+    };
+
+    /**
+     * Étape d'assignation. Hamerly et Elkan gardent des bornes sur les distances (inégalité
+     * triangulaire) pour sauter la plupart des calculs, avec exactement les mêmes assignations que Lloyd.
+     */
+    enum class Algorithm {
+        Auto,     // Hamerly pour moins de kElkanMinClusters clusters, Elkan au-delà.
+        Lloyd,    // Toutes les distances ligne x centroid à chaque itération.
+        Hamerly,  // Une borne supérieure et une borne inférieure par ligne (mémoire O(n)).
+        Elkan     // Une borne inférieure par ligne et par centroid (mémoire O(n * k)).
+    };
+
+    static constexpr std::size_t kParallelInitRows = 50000;
+    static constexpr std::size_t kElkanMinClusters = 20;
+
+    Init init = Init::Auto;
+    Algorithm algorithm = Algorithm::Auto;
+    std::uint64_t seed = 42;           // Graine de l'initialisation : même graine, mêmes centroids.
+    std::size_t oversampling = 0;      // k-means|| : candidats attendus par passe (0 = 2 * numClusters).
+    std::size_t initRounds = 5;        // k-means|| : nombre de passes de suréchantillonnage.
+    std::size_t numThreads = 0;        // Threads de l'entraînement (0 = pool partagé ThreadPool::shared(), 1 = séquentiel).
+    std::size_t nInit = 1;             // Entraînements indépendants (graines seed, seed + 1, ...) ; le meilleur est gardé.
+};
+
+/**
+ * Résumé d'un des `nInit` entraînements d'une représentation.
+ */
+struct KMeansRestart {
+    std::uint64_t seed = 0;                // Graine de l'initialisation.
+    int iterations = 0;                    // Itérations de Lloyd.
+    double inertia = 0.0;                  // Inertie finale (somme des distances au carré).
+    std::size_t distanceEvaluations = 0;   // Distances ligne x centroid calculées par les assignations.
+};
 
 class KMeans {
 public:
@@ -16,18 +66,65 @@ public:
      *   - numFeatures (int) : Nombre de dimensions dans les descripteurs.
      *   - maxIterations (int) : Nombre maximal d'itérations pour l'algorithme (par défaut 100).
      *   - tolerance (double) : Tolérance pour la convergence (par défaut 1e-4).
+     *   - options (KMeansOptions) : Initialisation, graine, algorithme et nombre d'entraînements (par
+     *     défaut k-means++, graine 42, assignation accélérée selon le nombre de clusters, un entraînement).
      * Sortie : Une instance initialisée de `KMeans`.
      */
-    KMeans(int numClusters, int numFeatures, int maxIterations = 100, double tolerance = 1e-4);
+    KMeans(int numClusters, int numFeatures, int maxIterations = 100, double tolerance = 1e-4,
+           const KMeansOptions& options = KMeansOptions());
 
     /**
      * Entraîne le modèle KMeans sur un ensemble d'images.
      * Entrée :
      *   - images (std::vector<Image>&) : Ensemble d'images utilisées pour l'entraînement.
      * Sortie : Aucune (met à jour les centroids et leurs labels associés).
+     * Les représentations présentes sont entraînées en parallèle.
      */
     void fit(const std::vector<Image>& images);
 
+    /**
+     * Entraîne le modèle KMeans sur la matrice de descripteurs d'une représentation.
+     * Entrée :
+     *   - data (FeatureMatrix&) : Descripteurs et labels d'entraînement d'une même représentation.
+     * Sortie : Aucune (met à jour les centroids de la représentation et leurs labels associés).
+     * Les assignations et les mises à jour sont réparties sur `options.numThreads` threads ; les
+     * sommes partielles sont réduites dans un ordre fixe, les centroids ne dépendent pas du nombre de threads.
+     * Avec `options.nInit` > 1, les entraînements sont lancés en parallèle et le modèle d'inertie
+     * minimale (le premier en cas d'égalité) est gardé ; chacun garde ses propres bornes en mémoire.
+     */
+    void fit(const FeatureMatrix& data);
+
+    /**
+     * Met à jour les centroids avec un lot de lignes (KMeans par mini-lots, Sculley 2010).
+     * Entrée :
+     *   - batch (FeatureMatrix&) : Lot de descripteurs et labels d'une même représentation.
+     *   - drift (double*) : Si non nul, reçoit le plus grand déplacement d'un centroid pendant ce lot.
+     * Sortie (bool) :
+     *   - true si les centroids ont été mis à jour.
+     *   - false si le lot ne peut pas être utilisé (dimension différente des centroids, ou premier
+     *     lot de moins de `numClusters` lignes).
+     * Les lignes du lot sont assignées aux centroids d'avant le lot ; chaque centroid se rapproche
+     * ensuite de chacune de ses lignes avec le taux 1 / (nombre de lignes qu'il a reçues), ce qui en
+     * fait la moyenne de toutes ses lignes. Le premier lot d'une représentation non entraînée choisit
+     * les centroids initiaux (selon `options.init`) ; après `fit`, chaque centroid repart de
+     * l'effectif de son cluster. Les labels des centroids suivent les labels reçus.
+     */
+    bool partialFit(const FeatureMatrix& batch, double* drift = nullptr);
+
+    /**
+     * Entraîne le modèle par mini-lots lus sur disque, sans charger tout le dataset.
+     * Entrée :
+     *   - path (std::string) : Dossier de fichiers de descripteurs ou fichier binaire (voir `DescriptorBatchReader`).
+     *   - batchSize (size_t) : Nombre de lignes par lot (par défaut 1024).
+     * Sortie (bool) :
+     *   - true si au moins une passe a été faite.
+     *   - false si la source ne peut pas être lue.
+     * Repart de zéro pour la représentation de la source, puis enchaîne des passes de `partialFit`
+     * (au plus `maxIterations`) jusqu'à ce que le plus grand déplacement d'un centroid sur une passe
+     * soit inférieur à `tolerance`. Une dernière lecture calcule l'inertie avec les centroids finaux.
+     */
+    bool fitStream(const std::string& path, std::size_t batchSize = 1024);
+
     /**
      * Prédit le label d'une image donnée avec un score de confiance.
      * Entrée :
@@ -37,51 +134,156 @@ public:
      */
     std::pair<int, double> predictLabelWithConfidence(const Image& image) const;
 
+    /**
+     * Même prédiction à partir d'une ligne de descripteurs (ex. `FeatureMatrix::row`), sans `Image`.
+     * Entrée :
+     *   - features (const double*) : Descripteurs de la requête.
+     *   - size (size_t) : Nombre de descripteurs.
+     *   - representation (RepresentationId) : Représentation des descripteurs.
+     * Sortie (std::pair<int, double>) : Label prédit et score de confiance ({-1, 0} en cas d'erreur).
+     */
+    std::pair<int, double> predictLabelWithConfidence(const double* features, std::size_t size,
+                                                      RepresentationId representation) const;
+
+    /**
+     * Centroids appris pour une représentation.
+     * Entrée :
+     *   - representation (RepresentationId) : Représentation entraînée.
+     * Sortie (FeatureMatrix&) : Une ligne par cluster (matrice vide si la représentation n'a pas été entraînée).
+     */
+    const FeatureMatrix& getCentroids(RepresentationId representation) const;
+
+    /**
+     * Nombre d'itérations de Lloyd (passes pour `fitStream`) du dernier entraînement d'une
+     * représentation (0 si non entraînée). Avec `nInit` > 1 : celui de l'entraînement gardé, comme
+     * `getInertia` et `getDistanceEvaluations`.
+     */
+    int getIterations(RepresentationId representation) const;
+
+    /**
+     * Inertie du dernier entraînement d'une représentation : somme des distances au carré de chaque
+     * ligne à son centroid final (`fitStream` relit la source une fois de plus pour la calculer ;
+     * 0 si non entraînée).
+     */
+    double getInertia(RepresentationId representation) const;
+
+    /**
+     * Nombre de distances ligne x centroid calculées par les assignations du dernier entraînement
+     * d'une représentation (Lloyd : lignes x clusters x itérations).
+     */
+    std::size_t getDistanceEvaluations(RepresentationId representation) const;
+
+    /**
+     * Résumés des entraînements du dernier `fit` d'une représentation, dans l'ordre des graines
+     * (`nInit` entrées ; une seule pour `fitStream`, aucune si non entraînée).
+     */
+    const std::vector<KMeansRestart>& getRestarts(RepresentationId representation) const;
+
+    /**
+     * Index dans `getRestarts` de l'entraînement gardé.
+     */
+    std::size_t getBestRestart(RepresentationId representation) const;
+
 private:
     int numClusters;             // Nombre de clusters (classes) à former.
     int numFeatures;             // Nombre de dimensions dans les descripteurs des images.
     int maxIterations;           // Nombre maximal d'itérations autorisées pour la convergence.
     double tolerance;            // Seuil de tolérance pour considérer que les centroids ont convergé.
+    KMeansOptions options;
+    std::unique_ptr<ThreadPool> ownPool;  // Pool créé une fois si options.numThreads > 1 (sinon pool partagé ou séquentiel).
 
     /**
      * Centroids calculés pour chaque représentation (type de descripteur).
-     * Structure : {nom de la représentation -> vecteurs des centroids}.
+     * Structure : [index de la représentation -> matrice des centroids (une ligne par cluster)],
+     * vide si la représentation n'a pas été entraînée.
      */
-    std::unordered_map<std::string, std::vector<std::vector<double>>> centroidsByRepresentation;
+    std::array<FeatureMatrix, kRepresentationCount> centroidsByRepresentation;
 
     /**
      * Labels associés aux centroids pour chaque représentation.
-     * Structure : {nom de la représentation -> labels associés}.
+     * Structure : [index de la représentation -> labels associés].
+     */
+    std::array<std::vector<int>, kRepresentationCount> centroidLabelsByRepresentation;
+
+    std::array<int, kRepresentationCount> iterationsByRepresentation{};    // Itérations du dernier entraînement.
+    std::array<double, kRepresentationCount> inertiaByRepresentation{};   // Inertie finale.
+    std::array<std::size_t, kRepresentationCount> distanceEvaluationsByRepresentation{};
+    std::array<std::vector<KMeansRestart>, kRepresentationCount> restartsByRepresentation;
+    std::array<std::size_t, kRepresentationCount> bestRestartByRepresentation{};
+
+    /**
+     * Par représentation et par centroid : nombre de lignes reçues (taux d'apprentissage de
+     * `partialFit`) et décompte de leurs labels.
      */
-    std::unordered_map<std::string, std::vector<int>> centroidLabelsByRepresentation;
+    std::array<std::vector<double>, kRepresentationCount> clusterWeightsByRepresentation;
+    std::array<std::vector<std::map<int, int>>, kRepresentationCount> clusterLabelCountsByRepresentation;
+
+    /**
+     * Entraîne une représentation (voir `fit`).
+     * Entrée :
+     *   - data (FeatureMatrix&) : Descripteurs d'entraînement non vides (disposition RowMajor).
+     *   - pool (ThreadPool&) : Pool des entraînements indépendants et, au-delà d'un bloc de lignes,
+     *     de leurs étapes (partagé entre représentations).
+     */
+    void fitRepresentation(const FeatureMatrix& data, ThreadPool& pool);
+
+    /**
+     * Un entraînement complet (initialisation puis itérations) à partir d'une graine.
+     * Entrée :
+     *   - rows (FeatureMatrix&) : Descripteurs d'entraînement (disposition RowMajor).
+     *   - seed (uint64_t) : Graine de l'initialisation.
+     *   - pool (ThreadPool&) : Pool des étapes parallèles.
+     *   - centroids (FeatureMatrix&) : Reçoit les centroids finaux.
+     *   - assignments (std::vector<int>&) : Reçoit le cluster de chaque ligne.
+     *   - summary (KMeansRestart&) : Reçoit la graine, les itérations, l'inertie et les distances calculées.
+     */
+    void fitOnce(const FeatureMatrix& rows, std::uint64_t seed, ThreadPool& pool, FeatureMatrix& centroids,
+                 std::vector<int>& assignments, KMeansRestart& summary) const;
+
+    /**
+     * Choisit les centroids initiaux selon `options.init`.
+     * Entrée :
+     *   - data (FeatureMatrix&) : Descripteurs d'entraînement (disposition RowMajor).
+     *   - seed (uint64_t) : Graine du tirage.
+     *   - pool (ThreadPool&) : Pool des calculs de distances.
+     * Sortie (FeatureMatrix) : `numClusters` lignes de `data`.
+     */
+    FeatureMatrix seedCentroids(const FeatureMatrix& data, std::uint64_t seed, ThreadPool& pool) const;
 
     /**
      * Calcule la distance entre deux vecteurs.
      * Entrée :
-     *   - a (std::vector<double>&) : Premier vecteur.
-     *   - b (std::vector<double>&) : Second vecteur.
+     *   - a (const double*) : Premier vecteur.
+     *   - b (const double*) : Second vecteur.
+     *   - size (size_t) : Nombre de descripteurs.
      * Sortie (double) : Distance calculée entre les deux vecteurs.
      */
-    double calculateDistance(const std::vector<double>& a, const std::vector<double>& b) const;
+    double calculateDistance(const double* a, const double* b, std::size_t size) const;
 
     /**
      * Calcule un score de confiance pour une prédiction.
      * Entrée :
-     *   - features (std::vector<double>&) : Descripteur de l'image.
+     *   - features (const double*) : Descripteurs de l'image (de la dimension des centroids).
+     *   - centroids (FeatureMatrix&) : Centroids de la représentation de l'image.
      *   - closestCluster (int) : Index du cluster le plus proche.
      * Sortie (double) : Score de confiance pour la prédiction.
      */
-    double calculateConfidence(const std::vector<double>& features, int closestCluster) const;
+    double calculateConfidence(const double* features, const FeatureMatrix& centroids, int closestCluster) const;
 
     /**
      * Associe des labels aux centroids à partir des données d'entraînement.
      * Entrée :
-     *   - images (std::vector<Image>&) : Ensemble des images utilisées pour l'entraînement.
+     *   - data (FeatureMatrix&) : Descripteurs et labels utilisés pour l'entraînement.
      *   - assignments (std::vector<int>&) : Assignations des images aux clusters.
-     *   - centroids (std::vector<std::vector<double>>&) : Centroids calculés pendant l'entraînement.
      * Sortie : Aucune (met à jour les labels des centroids).
      */
-    void associateLabelsToCentroids(const std::vector<Image>& images, const std::vector<int>& assignments, const std::vector<std::vector<double>>& centroids);
+    void associateLabelsToCentroids(const FeatureMatrix& data, const std::vector<int>& assignments);
+
+    /**
+     * Donne à chaque centroid d'une représentation son label le plus fréquent (le plus petit en cas
+     * d'égalité, -1 pour un cluster vide).
+     */
+    void updateCentroidLabels(std::size_t representation);
 };
 
 #endif // KMEANS_H
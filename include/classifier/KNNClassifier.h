@@ -5,15 +5,54 @@
 #include <string>
 #include <utility> 
 #include "dataRepo/Image.h"
-#include <unordered_map>
+#include "dataRepo/FeatureMatrix.h"
+#include "classifier/DistancePolicy.h"
+#include "classifier/NeighborIndex.h"
+#include "classifier/HNSWIndex.h"
+#include "classifier/PQIndex.h"
+#include "classifier/IVFIndex.h"
+#include "classifier/PrunedScanIndex.h"
+#include "classifier/KNNGraph.h"
+#include "classifier/QueryContext.h"
+#include <memory>
 
+/**
+ * Choix de la structure de recherche utilisée par `KNNClassifier`.
+ */
+struct KNNIndexOptions {
+    enum class Backend {
+        Auto,        // KD-tree si la dimension <= kdTreeMaxDimension, force brute sinon.
+        BruteForce,  // Parcours exhaustif.
+        KDTree,      // KD-tree exact, quelle que soit la dimension.
+        HNSW,        // Graphe HNSW approché (jamais choisi par Auto).
+        PQ,          // Codes compressés par quantification produit + reclassement exact (approché) ;
+                     // le dataset complet reste en mémoire, sauf s'il est une vue sur un .rfds mappé.
+        IVF,         // Listes inversées sur des centroids KMeans, nprobe listes parcourues (approché).
+        PrunedScan   // Parcours exhaustif avec abandon anticipé et pivots (exact, requête par requête ;
+                     // jamais choisi par Auto : le calcul par tuiles de `predictBatch` reste plus rapide).
+    };
+
+    Backend backend = Backend::Auto;
+    std::size_t kdTreeMaxDimension = 32;  // Zernike7 (18) et Yang (29) utilisent le KD-tree.
+    std::size_t kdTreeLeafSize = 16;
+    HNSWParameters hnsw;
+    PQParameters pq;
+    IVFParameters ivf;
+    PrunedScanParameters prunedScan;
+};
 
 class KNNClassifier {
 protected:
-    std::vector<Image> dataset; 
+    FeatureMatrix dataset; 
     int k;                       
-    std::string distanceType;    
-    std::unordered_map<std::string, std::unordered_map<int, std::vector<std::pair<std::string, double>>>> distancesByRepresentationAndLabel;
+    DistancePolicy distancePolicy; // Distance résolue à la construction.
+    FeatureMatrix::Buffer trainPanels;       // Dataset réorganisé en panneaux pour `predictBatch` (euclidienne).
+    std::vector<double> trainSquaredNorms;   // ||t||² de chaque ligne d'entraînement.
+    double maxTrainSquaredNorm;
+    KNNIndexOptions indexOptions;
+    std::shared_ptr<const NeighborIndex> index; // nullptr : force brute.
+    int labelBase;               // Plus petit label du dataset.
+    std::size_t labelCount;      // Labels du dataset dans [labelBase, labelBase + labelCount).
 
 public:
     /**
@@ -21,10 +60,26 @@ public:
      * Entrée :
      *   - data (std::vector<Image>&) : Dataset d'entraînement.
      *   - kValue (int) : Nombre de voisins à considérer.
-     *   - distType (std::string) : Type de distance utilisé.
+     *   - distType (std::string) : Type de distance utilisé ("euclidean" ou "manhattan").
+     *   - options (KNNIndexOptions) : Structure de recherche (par défaut choisie selon la dimension).
      * Sortie : Une instance initialisée de `KNNClassifier`.
+     * Lève `std::invalid_argument` si le type de distance n'est pas reconnu.
      */
-    KNNClassifier(const std::vector<Image>& data, int kValue, const std::string& distType);
+    KNNClassifier(const std::vector<Image>& data, int kValue, const std::string& distType,
+                  const KNNIndexOptions& options = KNNIndexOptions());
+
+    /**
+     * Constructeur de KNN à partir d'une matrice contiguë de descripteurs.
+     * Entrée :
+     *   - data (FeatureMatrix) : Descripteurs et labels d'entraînement (disposition RowMajor).
+     *   - kValue (int) : Nombre de voisins à considérer.
+     *   - distType (std::string) : Type de distance utilisé ("euclidean" ou "manhattan").
+     *   - options (KNNIndexOptions) : Structure de recherche (par défaut choisie selon la dimension).
+     * Sortie : Une instance initialisée de `KNNClassifier`.
+     * Lève `std::invalid_argument` si le type de distance n'est pas reconnu.
+     */
+    KNNClassifier(FeatureMatrix data, int kValue, const std::string& distType,
+                  const KNNIndexOptions& options = KNNIndexOptions());
 
     /**
      * Calcule la distance entre deux images.
@@ -35,15 +90,39 @@ public:
      */
     double calculateDistance(const Image& img1, const Image& img2) const;
 
+    /**
+     * Calcule la distance entre deux vecteurs de descripteurs.
+     * Entrée :
+     *   - a (const double*) : Premier vecteur.
+     *   - b (const double*) : Second vecteur.
+     *   - size (size_t) : Nombre de descripteurs.
+     * Sortie (double) : Distance calculée entre les deux vecteurs.
+     */
+    double calculateDistance(const double* a, const double* b, std::size_t size) const;
+
     /**
      * Trouve les K plus proches voisins pour une image donnée.
      * Entrée :
      *   - queryImage (Image&) : Image de requête.
      * Sortie (std::vector<std::pair<double, int>>) :
      *   - Liste des K plus proches voisins sous forme de paires (distance, label).
+     * Le classement se fait sur la distance de classement de `distancePolicy` ; seule la distance
+     * des K voisins retenus est convertie en vraie distance. Avec le KD-tree, les voisins sont les
+     * mêmes qu'avec le parcours exhaustif ; avec HNSW, ils sont approchés.
      */
     std::vector<std::pair<double, int>> findKNearestNeighbors(const Image& queryImage) const;
 
+    /**
+     * Trouve les K plus proches voisins dans les tampons d'un contexte, sans allocation une fois
+     * le contexte rodé.
+     * Entrée :
+     *   - query (const double*) : Descripteurs de la requête (dimension du dataset).
+     *   - context (QueryContext&) : Tampons de la requête.
+     * Sortie (std::vector<std::pair<double, int>>&) : `context.neighbors()`, les mêmes voisins que
+     * `findKNearestNeighbors`.
+     */
+    const std::vector<std::pair<double, int>>& findKNearestNeighbors(const double* query, QueryContext& context) const;
+
     /**
      * Prédit le label d'une image donnée.
      * Entrée :
@@ -58,9 +137,41 @@ public:
      *   - queryImage (Image&) : Image de requête.
      * Sortie (std::pair<int, double>) :
      *   - Pair contenant le label prédit et le score de confiance associé.
+     * Utilise un `QueryContext` par thread : aucune allocation après les premières requêtes.
      */
     std::pair<int, double> predictLabelWithConfidence(const Image& queryImage) const;
 
+    /**
+     * Prédit le label d'une requête avec un score de confiance, dans les tampons d'un contexte.
+     * Entrée :
+     *   - query (const double*) : Descripteurs de la requête (dimension du dataset).
+     *   - context (QueryContext&) : Tampons de la requête.
+     * Sortie (std::pair<int, double>) : Même résultat que `predictLabelWithConfidence(Image)`.
+     */
+    std::pair<int, double> predictLabelWithConfidence(const double* query, QueryContext& context) const;
+
+    /**
+     * Trouve les K plus proches voisins d'un lot de requêtes.
+     * Entrée :
+     *   - queries (FeatureMatrix&) : Descripteurs des requêtes (une par ligne).
+     * Sortie (std::vector<std::vector<std::pair<double, int>>>) :
+     *   - Pour chaque requête, les mêmes voisins que `findKNearestNeighbors`.
+     * En distance euclidienne, les distances requêtes x entraînement sont calculées par tuiles avec
+     * ||q||² + ||t||² - 2 q.t ; les candidats proches du K-ième (à l'erreur d'arrondi près) sont
+     * ensuite reclassés avec le noyau exact. Avec un index, chaque requête passe par l'index.
+     */
+    std::vector<std::vector<std::pair<double, int>>> findKNearestNeighborsBatch(const FeatureMatrix& queries) const;
+
+    /**
+     * Prédit le label d'un lot d'images avec un score de confiance.
+     * Entrée :
+     *   - queries (FeatureMatrix& ou std::vector<Image>&) : Images de requête.
+     * Sortie (std::vector<std::pair<int, double>>) :
+     *   - Pour chaque requête, le même résultat que `predictLabelWithConfidence`.
+     */
+    std::vector<std::pair<int, double>> predictBatch(const FeatureMatrix& queries) const;
+    std::vector<std::pair<int, double>> predictBatch(const std::vector<Image>& queries) const;
+
 
     void setK(int kValue);
     void printDatasetInfo() const;
@@ -74,29 +185,75 @@ public:
     void checkClassBalance(const std::vector<Image>& data);
 
     /**
-     * Calcule et stocke les distances entre les images pour optimisation.
-     * Entrée : Aucune.
-     * Sortie : Aucune.
+     * Construit le graphe des K plus proches voisins du dataset d'entraînement (chaque image
+     * exclue de ses propres voisins), avec la distance du classifieur.
+     * Entrée :
+     *   - kNeighbors (size_t) : Nombre de voisins par image.
+     *   - numThreads (size_t) : Nombre de threads (0 = pool partagé `ThreadPool::shared()`, 1 = séquentiel).
+     * Sortie (KNNGraph) : Graphe exact, enregistrable avec `KNNGraph::save`.
+     */
+    KNNGraph buildNeighborGraph(std::size_t kNeighbors, std::size_t numThreads = 0) const;
+
+    /**
+     * Nom de la structure de recherche utilisée ("force brute", "KD-tree" etc).
+     */
+    const char* indexName() const;
+
+private:
+    /**
+     * Construit l'index demandé par `indexOptions` (et les panneaux de `predictBatch` sans index).
+     */
+    void buildIndex();
+
+    /**
+     * Fait de `dataset` une vue sur un buffer partagé et la retourne, pour qu'un index qui relit
+     * les lignes complètes (PQ) les partage avec le classifieur au lieu de les copier.
+     */
+    FeatureMatrix sharedDataset();
+
+    /**
+     * Propose à `selector` les voisins d'une requête de la dimension du dataset.
+     */
+    void searchRow(const double* query, TopKSelector& selector) const;
+
+    /**
+     * Range le dataset en panneaux de `DistanceKernels::kPanelWidth` lignes et calcule les normes.
+     */
+    void buildBatchPanels();
+
+    /**
+     * Calcule `labelBase` et `labelCount` à partir des labels du dataset.
+     */
+    void computeLabelRange();
+
+    /**
+     * Cherche les voisins d'une image dans `context` (voisins à DBL_MAX si la dimension diffère).
      */
-    void calculateAndStoreDistances();
+    void searchImage(const Image& queryImage, QueryContext& context) const;
 
     /**
-     * Affiche les distances stockées pour débogage ou vérification.
-     * Entrée : Aucune.
-     * Sortie : Affichage .
+     * Vote majoritaire parmi des voisins triés par distance croissante. À égalité de voix, le
+     * label dont le premier voisin est le plus proche l'emporte.
+     * Sortie (std::pair<int, double>) : Label prédit et proportion de voix.
      */
-    void printStoredDistances() const;
+    std::pair<int, double> voteLabel(const std::vector<std::pair<double, int>>& neighbors, QueryContext& context) const;
 };
 
 /**
  * Trouve la valeur optimale de K pour le classifieur KNN à l'aide de la validation croisée.
+ * Les plis sont stratifiés par label et évalués en parallèle ; chaque pli ne cherche qu'une fois
+ * les maxK plus proches voisins de ses images et note chaque K de 1 à maxK sur le préfixe de ses
+ * K premiers voisins (même vote que `predictLabelWithConfidence`).
  * Entrée :
  *   - data (std::vector<Image>&) : Dataset à utiliser pour l'évaluation.
  *   - distanceType (std::string) : Type de distance utilisé.
  *   - maxK (int) : Valeur maximale de K à tester.
  *   - numFolds (int) : Nombre de plis pour la validation croisée (par défaut 5).
- * Sortie (int) : Valeur optimale pour K.
+ *   - accuracyByK (std::vector<double>*) : Si non nul, reçoit la précision de chaque K (index K - 1).
+ * Sortie (int) : Valeur optimale pour K (la plus petite en cas d'égalité).
+ * Lève `std::invalid_argument` si maxK < 1 ou numFolds < 2.
  */
-int findOptimalKWithCrossValidation(const std::vector<Image>& data, const std::string& distanceType, int maxK, int numFolds = 5);
+int findOptimalKWithCrossValidation(const std::vector<Image>& data, const std::string& distanceType, int maxK, int numFolds = 5,
+                                    std::vector<double>* accuracyByK = nullptr);
 
 #endif
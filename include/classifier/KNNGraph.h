@@ -0,0 +1,117 @@
+#ifndef KNNGRAPH_H
+#define KNNGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Graphe des K plus proches voisins de chaque ligne d'un dataset (la ligne elle-même exclue),
+ * stocké au format CSR : les voisins de la ligne i occupent [offset(i), offset(i + 1)) dans
+ * deux tableaux plats (index uint32 des voisins, vraies distances), triés par distance croissante
+ * puis par index croissant. Le graphe ne dépend que des données : l'ordre des calculs et le nombre
+ * de threads ne changent pas le résultat.
+ *
+ * Format du fichier (ordre d'octets natif) :
+ *   - En-tête `Header` (magic, version, distance, nombre de lignes, K, nombre d'arêtes, représentation).
+ *   - Table des labels : `rows` entiers int32.
+ *   - Table des offsets : `rows + 1` entiers uint64.
+ *   - Index des voisins : `edges` entiers uint32.
+ *   - Distances : `edges` doubles.
+ */
+class KNNGraph {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    KNNGraph();
+
+    /**
+     * Construit le graphe exact des K plus proches voisins.
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset (disposition RowMajor).
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - k (size_t) : Nombre de voisins par ligne (ramené à rows - 1 si besoin).
+     *   - numThreads (size_t) : Nombre de threads (0 = pool partagé `ThreadPool::shared()`, 1 = séquentiel).
+     * Sortie (KNNGraph) : Graphe construit.
+     * Les lignes sont découpées en blocs et chaque tuile (bloc I, bloc J) avec I <= J n'est calculée
+     * qu'une fois : une distance d(a, b) alimente à la fois la sélection de a et celle de b. Les tuiles
+     * sont ordonnancées en tournoi (méthode du cercle) : les tuiles d'une même ronde touchent des blocs
+     * disjoints et se calculent en parallèle sans verrou.
+     * Lève `std::invalid_argument` si la dimension de `policy` ne correspond pas à `data`.
+     */
+    static KNNGraph build(const FeatureMatrix& data, const DistancePolicy& policy, std::size_t k, std::size_t numThreads = 0);
+
+    /**
+     * Écrit le graphe dans un fichier binaire.
+     * Entrée :
+     *   - filePath (std::string) : Chemin du fichier à créer.
+     * Sortie (bool) :
+     *   - true si l'écriture réussit.
+     *   - false sinon.
+     */
+    bool save(const std::string& filePath) const;
+
+    /**
+     * Relit un graphe écrit par `save`.
+     * Entrée :
+     *   - filePath (std::string) : Chemin du fichier.
+     * Sortie (bool) :
+     *   - true si le fichier est valide (le graphe est alors remplacé).
+     *   - false sinon (le graphe est inchangé).
+     */
+    bool load(const std::string& filePath);
+
+    std::size_t rows() const { return labels.size(); }
+    std::size_t neighborCount() const { return kNeighbors; }
+    std::size_t edgeCount() const { return targets.size(); }
+    DistanceMetric metric() const { return distanceMetric; }
+    RepresentationId getRepresentationId() const { return representation; }
+
+    /**
+     * Nombre de voisins de la ligne i.
+     */
+    std::size_t degree(std::size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+    /**
+     * Index des voisins de la ligne i (`degree(i)` valeurs, du plus proche au plus lointain).
+     */
+    const std::uint32_t* neighbors(std::size_t i) const { return targets.data() + offsets[i]; }
+
+    /**
+     * Vraies distances des voisins de la ligne i, dans le même ordre que `neighbors(i)`.
+     */
+    const double* distances(std::size_t i) const { return weights.data() + offsets[i]; }
+
+    int label(std::size_t i) const { return labels[i]; }
+
+    /**
+     * Taille mémoire des tableaux du graphe, en octets.
+     */
+    std::size_t memoryBytes() const;
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint32_t metric;
+        std::uint32_t reserved;
+        std::uint64_t rows;
+        std::uint64_t k;
+        std::uint64_t edges;
+        char representation[32];
+    };
+
+    DistanceMetric distanceMetric;
+    RepresentationId representation;
+    std::size_t kNeighbors;
+    std::vector<std::int32_t> labels;
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<double> weights;
+};
+
+#endif
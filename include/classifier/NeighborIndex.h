@@ -0,0 +1,31 @@
+#ifndef NEIGHBORINDEX_H
+#define NEIGHBORINDEX_H
+
+#include "classifier/TopKSelector.h"
+
+/**
+ * Index de recherche de voisins construit sur le dataset d'entraînement d'un `KNNClassifier`.
+ * Un index propose ses candidats à un `TopKSelector` (déjà initialisé avec K) sous la forme
+ * (distance de classement, label), avec la distance de classement de la `DistancePolicy` du
+ * classifieur.
+ */
+class NeighborIndex {
+public:
+    virtual ~NeighborIndex() = default;
+
+    /**
+     * Cherche les voisins d'une requête.
+     * Entrée :
+     *   - query (const double*) : Descripteurs de la requête (dimension du dataset).
+     *   - selector (TopKSelector&) : Sélection en cours, qui reçoit les candidats.
+     * Sortie : Aucune.
+     */
+    virtual void search(const double* query, TopKSelector& selector) const = 0;
+
+    /**
+     * Nom de l'index (pour l'affichage).
+     */
+    virtual const char* name() const = 0;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef PQINDEX_H
+#define PQINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "classifier/NeighborIndex.h"
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Paramètres de la quantification produit.
+ * Les codes occupent `subspaces` octets par ligne, mais l'index garde aussi les lignes complètes
+ * pour le reclassement exact : la mémoire n'est réduite que si ces lignes sont une vue sur un
+ * fichier .rfds mappé (voir `PQIndex`). Construit par `KNNClassifier` sur une matrice propre, l'index
+ * partage le buffer du classifieur et n'ajoute que les codes et les dictionnaires.
+ */
+struct PQParameters {
+    std::size_t subspaces = 0;           // Nombre de sous-espaces (0 = dimension / 4), soit un octet par sous-espace.
+    std::size_t centroids = 256;         // Centroids par sous-espace (au plus 256 : codes sur 8 bits).
+    std::size_t rerankFactor = 10;       // Taille de la liste reclassée exactement : rerankFactor * K.
+    std::size_t trainingSample = 4096;   // Lignes utilisées pour apprendre les dictionnaires (0 = toutes).
+    int trainIterations = 20;            // Itérations de KMeans par sous-espace.
+    std::size_t numThreads = 0;          // Threads d'apprentissage (0 = pool partagé ThreadPool::shared(), 1 = séquentiel).
+};
+
+/**
+ * Index compressé par quantification produit (Jégou et al.).
+ *
+ * Les descripteurs sont découpés en `subspaces` blocs de dimensions consécutives ; chaque bloc est
+ * remplacé par l'index (un octet) du centroid le plus proche d'un dictionnaire appris avec `KMeans`.
+ * Une requête calcule une table des distances de ses blocs à tous les centroids, puis parcourt les
+ * codes en sommant des lectures de table (distance asymétrique) : le parcours lit `subspaces`
+ * octets par ligne au lieu de 8 * dimension. Les rerankFactor * K meilleures lignes approchées
+ * sont ensuite reclassées avec la distance exacte, lue dans les lignes complètes.
+ *
+ * Les lignes complètes ne sont lues que pour ces candidats : passer à l'index une vue sur un
+ * fichier .rfds mappé en mémoire (`DescriptorStore::view`) évite de les garder en RAM.
+ */
+class PQIndex : public NeighborIndex {
+public:
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor). L'index garde
+     *     `data` pour le reclassement : copie complète si `data` possède son buffer, partage si
+     *     c'est une vue ou une tranche.
+     *   - policy (DistancePolicy) : Distance utilisée (euclidienne ou Manhattan).
+     *   - parameters (PQParameters) : Découpage, dictionnaires et reclassement.
+     * Sortie : Un index construit sur `data`.
+     */
+    PQIndex(const FeatureMatrix& data, const DistancePolicy& policy, const PQParameters& parameters = PQParameters());
+
+    /**
+     * Propose au sélecteur les voisins reclassés (distance de classement exacte).
+     */
+    void search(const double* query, TopKSelector& selector) const override;
+    const char* name() const override { return "PQ"; }
+
+    /**
+     * Modifie la taille de la liste reclassée sans reconstruire l'index.
+     */
+    void setRerankFactor(std::size_t factor) { parameters.rerankFactor = factor; }
+    std::size_t rerankFactor() const { return parameters.rerankFactor; }
+
+    std::size_t subspaceCount() const { return numSubspaces; }
+
+    /**
+     * Octets utilisés par les codes et les dictionnaires (hors lignes complètes).
+     */
+    std::size_t compressedBytes() const;
+
+private:
+    DistancePolicy policy;
+    PQParameters parameters;
+    FeatureMatrix vectors;                      // Lignes complètes, pour le reclassement.
+    std::size_t numSubspaces;
+    std::size_t numCentroids;
+    std::vector<std::size_t> subspaceBegin;     // Première dimension de chaque sous-espace (+ fin).
+    std::vector<double> codebooks;              // Sous-espace j : numCentroids lignes de taille (fin - début).
+    std::vector<std::size_t> codebookOffset;
+    std::vector<std::uint8_t> codes;            // rows * numSubspaces.
+
+    double subDistance(const double* a, const double* b, std::size_t size) const;
+    void encode(const double* values, std::uint8_t* code) const;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef PRUNEDSCANINDEX_H
+#define PRUNEDSCANINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "classifier/NeighborIndex.h"
+#include "classifier/DistancePolicy.h"
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Paramètres du parcours exhaustif élagué.
+ */
+struct PrunedScanParameters {
+    std::size_t pivots = 4;  // Pivots de l'inégalité triangulaire (0 = abandon anticipé seul).
+};
+
+/**
+ * Parcours exhaustif exact qui rejette la plupart des lignes avant d'avoir calculé leur distance.
+ *
+ * Les lignes sont rangées par panneaux de `DistanceKernels::kPanelWidth` (comme pour `predictBatch`),
+ * dimensions triées par variance décroissante.
+ * - Abandon anticipé : un panneau est parcouru dimension par dimension et abandonné dès que
+ *   toutes ses sommes partielles dépassent la distance du K-ième voisin courant.
+ * - Pivots : les distances de chaque ligne à quelques pivots (choisis par parcours du plus
+ *   éloigné) sont précalculées, et |d(q, p) - d(x, p)| minore d(q, x). Les lignes sont triées par
+ *   distance au premier pivot ; chaque panneau garde l'intervalle des distances de ses lignes à
+ *   chaque pivot, ce qui permet de sauter un panneau sans lire ses descripteurs. Les panneaux sont
+ *   visités à partir de celui où tomberait la requête, en s'éloignant des deux côtés, et la
+ *   recherche s'arrête quand les deux côtés sont hors de portée.
+ *
+ * Les sommes partielles et les bornes ne servent qu'à rejeter, avec une marge relative qui couvre
+ * les écarts d'arrondi ; les lignes retenues sont comparées avec le noyau exact de la
+ * `DistancePolicy` sur les lignes d'origine. Le résultat est identique à la force brute.
+ */
+class PrunedScanIndex : public NeighborIndex {
+public:
+    /**
+     * Entrée :
+     *   - data (FeatureMatrix&) : Dataset d'entraînement (disposition RowMajor), partagé et non copié
+     *     si c'est une vue.
+     *   - policy (DistancePolicy) : Distance utilisée.
+     *   - parameters (PrunedScanParameters) : Nombre de pivots.
+     * Sortie : Un index prêt à chercher dans `data`.
+     */
+    PrunedScanIndex(const FeatureMatrix& data, const DistancePolicy& policy,
+                    const PrunedScanParameters& parameters = PrunedScanParameters());
+
+    void search(const double* query, TopKSelector& selector) const override;
+    const char* name() const override { return "force brute élaguée"; }
+
+    std::size_t pivotCount() const { return pivotRows.size(); }
+
+private:
+    DistancePolicy policy;
+    DistanceKernels::BoundedPanelKernel panelKernel;
+    FeatureMatrix vectors;                     // Lignes d'origine, pour la distance exacte.
+    std::vector<std::size_t> dimensionOrder;   // Dimensions par variance décroissante.
+    FeatureMatrix::Buffer panels;              // Panneaux, dimensions dans l'ordre `dimensionOrder`.
+    std::vector<std::uint32_t> panelRows;      // Ligne d'origine de chaque place de panneau (UINT32_MAX : vide).
+    std::vector<std::size_t> pivotRows;
+    std::vector<double> pivotLow;              // Panneau p, pivot j : [pivotLow, pivotHigh] en p * P + j.
+    std::vector<double> pivotHigh;
+
+    std::size_t panelCount() const { return panelRows.size() / DistanceKernels::kPanelWidth; }
+
+    /**
+     * Choisit `count` pivots et rend les distances de chaque ligne à chacun (ligne i en [i * count, (i + 1) * count)).
+     */
+    std::vector<double> choosePivots(std::size_t count);
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef QUERYCONTEXT_H
+#define QUERYCONTEXT_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "classifier/TopKSelector.h"
+
+/**
+ * Tampons réutilisables d'une requête KNN : sélection des K voisins, liste des voisins trouvés et
+ * tableau de voix indexé par label. Ils ne grandissent qu'aux premières requêtes ; ensuite une
+ * prédiction de `KNNClassifier` avec le même contexte ne fait plus aucune allocation.
+ *
+ * Un contexte ne doit servir qu'à un thread à la fois (un par thread, ou un par tâche).
+ */
+class QueryContext {
+public:
+    QueryContext() = default;
+
+    /**
+     * Voisins de la dernière requête, triés par distance croissante (vraies distances).
+     * Valides jusqu'à la requête suivante avec ce contexte.
+     */
+    const std::vector<TopKSelector::Neighbor>& neighbors() const { return found; }
+
+    /**
+     * Vote majoritaire parmi des voisins triés par distance croissante. À égalité de voix, le
+     * label dont le premier voisin est le plus proche l'emporte.
+     * Entrée :
+     *   - neighbors (std::vector<Neighbor>&) : Voisins triés.
+     *   - labelBase (int) : Plus petit label possible.
+     *   - labelCount (size_t) : Nombre de labels possibles (labels dans [labelBase, labelBase + labelCount)).
+     * Sortie (std::pair<int, int>) : Label gagnant et son nombre de voix ((-1, 0) sans voisin).
+     */
+    std::pair<int, int> vote(const std::vector<TopKSelector::Neighbor>& neighbors, int labelBase, std::size_t labelCount);
+
+private:
+    friend class KNNClassifier;
+
+    TopKSelector selector;
+    std::vector<TopKSelector::Neighbor> found;
+    std::vector<int> votes;  // Voix du label labelBase + i en i ; remis à zéro après chaque vote.
+};
+
+#endif
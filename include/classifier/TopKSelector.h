@@ -0,0 +1,87 @@
+#ifndef TOPKSELECTOR_H
+#define TOPKSELECTOR_H
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/**
+ * Sélection des K plus petites paires (distance, label) d'un flux de candidats, sans trier
+ * tout le flux. L'ordre est celui de `std::pair` : à distance égale, le plus petit label gagne,
+ * comme avec un tri complet.
+ *
+ * - Petit K (<= kInsertionLimit) : tampon trié par insertion, de taille K.
+ * - Grand K : tampon non trié de taille 2K, réduit à K par `nth_element` quand il est plein.
+ *
+ * `threshold()` donne la distance à battre ; la boucle de distance peut rejeter un candidat
+ * sans appeler `push`. Le tampon est conservé d'une requête à l'autre (`reset` ne libère rien).
+ */
+class TopKSelector {
+public:
+    using Neighbor = std::pair<double, int>;
+
+    static constexpr std::size_t kInsertionLimit = 16;
+
+    TopKSelector() : k(0), sorted(true), worst(unreachable()) {}
+
+    /**
+     * Prépare une nouvelle sélection.
+     * Entrée :
+     *   - kValue (size_t) : Nombre de voisins à garder.
+     * Sortie : Aucune.
+     */
+    void reset(std::size_t kValue);
+
+    /**
+     * Nombre de voisins gardés (K).
+     */
+    std::size_t capacity() const { return k; }
+
+    /**
+     * Distance de la K-ième meilleure paire (infinie tant que K candidats n'ont pas été vus).
+     * Un candidat de distance strictement supérieure ne peut pas être retenu.
+     */
+    double threshold() const { return worst.first; }
+
+    /**
+     * Propose un candidat.
+     */
+    void push(double distance, int label) {
+        Neighbor candidate(distance, label);
+        if (!(candidate < worst)) {
+            return;
+        }
+        if (sorted) {
+            insertSorted(candidate);
+        } else {
+            buffer.push_back(candidate);
+            if (buffer.size() == 2 * k) {
+                shrink();
+            }
+        }
+    }
+
+    /**
+     * Termine la sélection.
+     * Entrée :
+     *   - out (std::vector<Neighbor>&) : Reçoit les K meilleures paires, triées par ordre croissant.
+     * Sortie : Aucune.
+     */
+    void finish(std::vector<Neighbor>& out);
+
+private:
+    std::size_t k;
+    bool sorted;
+    Neighbor worst;
+    std::vector<Neighbor> buffer;
+
+    static Neighbor unreachable() {
+        return Neighbor(std::numeric_limits<double>::infinity(), std::numeric_limits<int>::max());
+    }
+
+    void insertSorted(const Neighbor& candidate);
+    void shrink();
+};
+
+#endif
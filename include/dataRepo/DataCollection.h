@@ -3,16 +3,19 @@
 
 #include <vector>
 #include <string>
-#include <map>
 #include <unordered_map>
 #include <filesystem>
 #include "../dataRepo/Image.h"
 #include "../dataRepo/DataRepresentation.h"
+#include "../dataRepo/FeatureMatrix.h"
+#include "../dataRepo/DescriptorStore.h"
+#include "../dataRepo/FingerprintIndex.h"
 
 class DataCollection {
     private:
-        std::map<Image, int> dataset; 
-        std::string representationType; 
+        std::vector<Image> dataset; // Images dans l'ordre d'ajout.
+        FingerprintIndex datasetIndex; // Empreintes des images de `dataset` pour détecter les doublons.
+        RepresentationId representation; 
         std::unordered_map<int, int> sampleCounts;
         std::vector<double> minValues; // Minimum descripteurs pour la normalisation
         std::vector<double> maxValues; // Maximum descripteurs pour la normalisation
@@ -46,13 +49,42 @@ public:
     /**
      * Charge un dataset le répertoire.
      * Parcourt un dossier contenant les fichiers de représentation et remplit le dataset.
+     * Les fichiers sont listés une fois, lus en parallèle, puis ajoutés à la suite du dataset dans
+     * l'ordre de leur chemin ; les erreurs de lecture sont regroupées et affichées dans le même
+     * ordre. Un fichier illisible est signalé puis ignoré, sans interrompre le chargement.
      * Entrée :
      *   - dirPath (std::string) : Chemin du répertoire à charger.
+     *   - numThreads (size_t) : Nombre de threads de lecture (0 = pool partagé
+     *     `ThreadPool::shared()`, 1 = séquentiel).
      * Sortie (bool) :
      *   - true si le chargement réussit.
      *   - false sinon.
      */
-    bool loadDatasetFromDirectory(const std::string& dirPath);
+    bool loadDatasetFromDirectory(const std::string& dirPath, std::size_t numThreads = 0);
+
+    /**
+     * Charge un dataset depuis un fichier binaire de descripteurs (voir `DescriptorStore`).
+     * Entrée :
+     *   - storePath (std::string) : Chemin du fichier binaire.
+     * Sortie (bool) :
+     *   - true si le chargement réussit.
+     *   - false sinon.
+     */
+    bool loadDatasetFromStore(const std::string& storePath);
+
+    /**
+     * Ouvre un fichier binaire de descripteurs comme matrice, sans passer par des `Image`.
+     * Entrée :
+     *   - storePath (std::string) : Chemin du fichier binaire.
+     *   - matrix (FeatureMatrix&) : Reçoit une vue sans copie sur le fichier mappé (descripteurs
+     *     float64), ou une matrice convertie (float32).
+     * Sortie (bool) :
+     *   - true si le fichier est valide et ses labels dans [1, 18].
+     *   - false sinon.
+     * Contrairement à `loadDatasetFromStore`, les doublons ne sont pas recherchés : le fichier est
+     * supposé écrit par scripts/pack_signatures depuis un dataset déjà filtré.
+     */
+    static bool loadMatrixFromStore(const std::string& storePath, FeatureMatrix& matrix);
 
     /**
      * Affiche les informations du data.
@@ -62,7 +94,29 @@ public:
     void printDataset() const;
 
 
-    std::vector<Image> getImages() const;
+    /**
+     * Accède aux images du dataset, sans copie.
+     * Entrée : Aucune.
+     * Sortie (const std::vector<Image>&) : Images dans l'ordre d'ajout.
+     */
+    const std::vector<Image>& getImages() const;
+
+    /**
+     * Construit la matrice contiguë des descripteurs du dataset chargé.
+     * Entrée : Aucune.
+     * Sortie (FeatureMatrix) : Matrice des descripteurs avec les labels associés.
+     */
+    FeatureMatrix getFeatureMatrix() const;
+
+    /**
+     * Construit une matrice contiguë à partir d'une liste d'images d'une même représentation.
+     * Entrée :
+     *   - images (std::vector<Image>&) : Images à copier (même type et même taille de descripteurs).
+     *   - layout (FeatureMatrix::Layout) : Disposition mémoire (par défaut RowMajor).
+     * Sortie (FeatureMatrix) : Matrice des descripteurs, labels et chemins des images.
+     * Lève std::invalid_argument si les images ne sont pas homogènes.
+     */
+    static FeatureMatrix buildFeatureMatrix(const std::vector<Image>& images, FeatureMatrix::Layout layout = FeatureMatrix::Layout::RowMajor);
 
     /**
      * @brief Divise un dataset en ensembles d'entraînement et de test.
@@ -79,10 +133,10 @@ public:
      * @brief Groupe les images par type de représentation.
      * Entrée :
      *   - images (std::vector<Image>&) : Liste des images à regrouper.
-     * Sortie (std::unordered_map<std::string, std::vector<Image>>) :
+     * Sortie (std::unordered_map<RepresentationId, std::vector<Image>>) :
      *   Une map associant chaque type de représentation à une liste d'images.
      */
-    std::unordered_map<std::string, std::vector<Image>> groupImagesByRepresentation(const std::vector<Image>& images) const;
+    std::unordered_map<RepresentationId, std::vector<Image>> groupImagesByRepresentation(const std::vector<Image>& images) const;
     bool loadTrainTestDatasets(const std::string& trainDir, const std::string& testDir);
 
     /**
@@ -95,6 +149,22 @@ public:
     const std::vector<Image>& getTestImages() const;
     void computeNormalizationBounds(const std::vector<Image>& images);
     void normalizeDataset(std::vector<Image>& images);
+
+    /**
+     * Bornes de normalisation calculées sur les lignes d'une matrice (même résultat que la
+     * version `Image`).
+     */
+    void computeNormalizationBounds(const FeatureMatrix& matrix);
+
+    /**
+     * Normalise une matrice avec les bornes courantes.
+     * Entrée :
+     *   - matrix (FeatureMatrix) : Descripteurs bruts, normalisés sur place s'ils sont passés par
+     *     déplacement ; une vue est copiée une fois.
+     * Sortie (FeatureMatrix) : Matrice propre normalisée, avec les labels et chemins de `matrix`.
+     * Lève std::invalid_argument si la dimension ne correspond pas aux bornes.
+     */
+    FeatureMatrix normalizeMatrix(FeatureMatrix matrix) const;
     static void savePRData(const std::string& filename, const std::vector<int>& trueLabels, const std::vector<double>& confidenceScores);
 };
 
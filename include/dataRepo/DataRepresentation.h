@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include "dataRepo/RepresentationTraits.h"
 
 class Image; 
 
@@ -11,7 +12,7 @@ class DataRepresentation {
 protected:
     std::string filePath;  
     std::vector<double> data;  
-    std::string representationType; 
+    RepresentationId representation; 
 
 public:
     /**
@@ -30,8 +31,19 @@ public:
      */
     bool readFile();
 
+    /**
+     * Lit le fichier sans écrire sur la sortie d'erreur (utilisable depuis plusieurs threads).
+     * Entrée :
+     *   - errorMessage (std::string&) : Reçoit le message d'erreur éventuel.
+     * Sortie (bool) :
+     *   - true si la lecture et l'extraction est réussit.
+     *   - false en cas d'erreur (message dans `errorMessage`).
+     */
+    bool readFile(std::string& errorMessage);
+
     const std::vector<double>& getData() const;
     const std::string& getRepresentationType() const;
+    RepresentationId getRepresentationId() const;
 
     /**
      * Charge les données à partir d'un répertoire et crée une liste d'objets `Image`.
@@ -50,9 +62,10 @@ private:
     /**
      *  Détermine le type de représentation à partir du fichier.
      * Entrée : Aucune.
-     * Sortie : modifie `representationType`.
+     * Sortie (bool) : false si le nombre de descripteurs ne correspond à aucun type,
+     *   `representation` vaut alors Unknown.
      */
-    void determineRepresentationType();
+    bool determineRepresentationType();
 
     /**
      * Extrait le label d'une image à partir de son nom de fichier.
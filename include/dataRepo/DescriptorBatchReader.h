@@ -0,0 +1,82 @@
+#ifndef DESCRIPTORBATCHREADER_H
+#define DESCRIPTORBATCHREADER_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "dataRepo/DescriptorStore.h"
+#include "dataRepo/FeatureMatrix.h"
+#include "parallel/ThreadPool.h"
+
+/**
+ * Lecture par lots des descripteurs d'une représentation, sans charger tout le dataset : seul le
+ * lot courant est en mémoire.
+ *
+ * Deux sources :
+ *   - Un dossier de fichiers texte (.gfd, .art, .yng, .txt), parcouru dans l'ordre des chemins
+ *     comme `DataCollection::loadDatasetFromDirectory`. La représentation est celle du premier
+ *     fichier ; les fichiers d'une autre extension sont ignorés. Les fichiers d'un lot sont lus en
+ *     parallèle.
+ *   - Un fichier binaire `DescriptorStore` (.rfds), mappé en mémoire : les pages déjà lues peuvent
+ *     être libérées par le système.
+ * Les descripteurs sont rendus tels qu'ils sont stockés (sans normalisation).
+ */
+class DescriptorBatchReader {
+public:
+    /**
+     * Entrée :
+     *   - numThreads (size_t) : Threads de lecture des fichiers texte (0 = pool partagé
+     *     `ThreadPool::shared()`, 1 = séquentiel).
+     */
+    explicit DescriptorBatchReader(std::size_t numThreads = 0);
+
+    /**
+     * Ouvre une source de descripteurs.
+     * Entrée :
+     *   - path (std::string) : Dossier de fichiers de descripteurs, ou fichier binaire de descripteurs.
+     * Sortie (bool) :
+     *   - true si la source contient au moins une ligne d'une représentation connue.
+     *   - false sinon.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Lit le lot suivant.
+     * Entrée :
+     *   - batch (FeatureMatrix&) : Reçoit au plus `batchSize` lignes (descripteurs, labels, chemins).
+     *   - batchSize (size_t) : Taille maximale du lot.
+     * Sortie (bool) :
+     *   - true si un lot non vide a été lu.
+     *   - false à la fin de la source.
+     */
+    bool next(FeatureMatrix& batch, std::size_t batchSize);
+
+    /**
+     * Revient au début de la source (nouvelle passe).
+     */
+    void rewind() { position = 0; }
+
+    /**
+     * Nombre de lignes de la source (fichiers retenus pour un dossier, dont ceux qui ne pourront
+     * pas être lus).
+     */
+    std::size_t size() const;
+
+    RepresentationId getRepresentationId() const { return representation; }
+
+private:
+    std::unique_ptr<ThreadPool> ownPool;  // Pool propre si numThreads > 1 (déclaré avant `pool`, qui peut y renvoyer).
+    ThreadPool& pool;
+    DescriptorStore store;
+    std::vector<std::pair<std::string, int>> files;  // Dossier : chemin et label de chaque fichier.
+    RepresentationId representation;
+    std::size_t position;
+
+    bool openDirectory(const std::string& dirPath);
+    bool nextFromDirectory(FeatureMatrix& batch, std::size_t batchSize);
+    bool nextFromStore(FeatureMatrix& batch, std::size_t batchSize);
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DESCRIPTORPARSER_H
+#define DESCRIPTORPARSER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Lecture rapide des fichiers texte de descripteurs (.gfd, .art, .yng, .txt).
+ * Le fichier est lu en entier dans un buffer réutilisé par thread, puis les nombres
+ * sont convertis avec `std::from_chars` (indépendant de la locale, sans flux).
+ */
+class DescriptorParser {
+public:
+    /**
+     * Lit et convertit un fichier de descripteurs.
+     * Entrée :
+     *   - path (std::string) : Chemin du fichier.
+     *   - out (std::vector<double>&) : Vecteur rempli avec les descripteurs (vidé avant lecture).
+     *   - expectedDimension (size_t) : Taille attendue pour réserver `out` (0 si inconnue).
+     *   - errorMessage (std::string&) : Reçoit le message d'erreur éventuel.
+     * Sortie (bool) :
+     *   - true si le fichier a été lu.
+     *   - false sinon.
+     */
+    static bool parseFile(const std::string& path, std::vector<double>& out, std::size_t expectedDimension, std::string& errorMessage);
+
+    /**
+     * Convertit un buffer texte en descripteurs.
+     * Accepte et rejette les mêmes entrées que `operator>>` (pas de "inf" ni de "nan") : la lecture
+     * s'arrête au premier élément qui n'est pas un nombre (vérifié par scripts/Check_parity.cpp).
+     * Entrée :
+     *   - begin (const char*) : Début du texte.
+     *   - end (const char*) : Fin du texte.
+     *   - out (std::vector<double>&) : Vecteur auquel les valeurs sont ajoutées.
+     * Sortie : Aucune.
+     */
+    static void parseBuffer(const char* begin, const char* end, std::vector<double>& out);
+
+    /**
+     * Devine le nombre de descripteurs attendu d'après l'extension du fichier.
+     * Entrée :
+     *   - path (std::string) : Chemin du fichier.
+     * Sortie (size_t) : 100 (.gfd), 36 (.art), 29 (.yng), 18 (.txt) ou 0 si inconnue.
+     */
+    static std::size_t expectedDimensionForPath(const std::string& path);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef DESCRIPTORSTORE_H
+#define DESCRIPTORSTORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include "dataRepo/FeatureMatrix.h"
+
+/**
+ * Fichier binaire versionné regroupant tous les descripteurs d'une représentation,
+ * ouvert avec `mmap` et exposé sans copie.
+ *
+ * Format (ordre d'octets natif) :
+ *   - En-tête `Header` (magic, version, type des éléments, dimension, stride, nombre de lignes,
+ *     nom de la représentation, offsets des tables).
+ *   - Table des labels : `count` entiers int32.
+ *   - Table des chemins : `count + 1` offsets uint64, puis les caractères des chemins.
+ *   - Bloc de descripteurs aligné sur 64 octets : `count * stride` float ou double.
+ */
+class DescriptorStore {
+public:
+    enum class ElementType : std::uint32_t { Float32 = 1, Float64 = 2 };
+
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kDataAlignment = 64;
+
+    DescriptorStore();
+    ~DescriptorStore();
+
+    DescriptorStore(const DescriptorStore&) = delete;
+    DescriptorStore& operator=(const DescriptorStore&) = delete;
+
+    /**
+     * Écrit une matrice de descripteurs dans un fichier binaire.
+     * Entrée :
+     *   - filePath (std::string) : Chemin du fichier à créer.
+     *   - matrix (FeatureMatrix&) : Descripteurs, labels et chemins à écrire.
+     *   - type (ElementType) : Précision des descripteurs stockés (par défaut Float64).
+     * Sortie (bool) :
+     *   - true si l'écriture réussit.
+     *   - false sinon.
+     */
+    static bool write(const std::string& filePath, const FeatureMatrix& matrix, ElementType type = ElementType::Float64);
+
+    /**
+     * Ouvre et mappe un fichier binaire en mémoire.
+     * Entrée :
+     *   - filePath (std::string) : Chemin du fichier.
+     * Sortie (bool) :
+     *   - true si le fichier est valide et mappé.
+     *   - false sinon.
+     */
+    bool open(const std::string& filePath);
+
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    std::size_t size() const { return count; }
+    std::size_t dimension() const { return dim; }
+    std::size_t stride() const { return rowStride; }
+    ElementType elementType() const { return type; }
+    const std::string& getRepresentationType() const { return representationName(representation); }
+    RepresentationId getRepresentationId() const { return representation; }
+
+    int label(std::size_t i) const;
+    std::string_view path(std::size_t i) const;
+
+    /**
+     * Accède à une ligne du bloc mappé, sans copie.
+     * Entrée :
+     *   - i (size_t) : Index de la ligne.
+     * Sortie : Pointeur vers la ligne, ou nullptr si le type stocké ne correspond pas.
+     */
+    const double* rowDouble(std::size_t i) const;
+    const float* rowFloat(std::size_t i) const;
+
+    /**
+     * Expose le contenu sous forme de `FeatureMatrix`.
+     * Entrée : Aucune.
+     * Sortie (FeatureMatrix) :
+     *   - Vue sans copie sur le fichier mappé si les descripteurs sont stockés en double.
+     *   - Copie convertie en double si les descripteurs sont stockés en float.
+     * La vue garde le mapping en vie même après la fermeture du `DescriptorStore`.
+     */
+    FeatureMatrix view() const;
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrderMark;
+        std::uint32_t elementType;
+        std::uint32_t dimension;
+        std::uint32_t stride;
+        std::uint32_t reserved;
+        std::uint64_t count;
+        std::uint64_t labelTableOffset;
+        std::uint64_t pathTableOffset;
+        std::uint64_t dataOffset;
+        char representation[32];
+    };
+
+    std::shared_ptr<const void> mapping;
+    const unsigned char* base;
+    std::size_t length;
+    std::size_t count;
+    std::size_t dim;
+    std::size_t rowStride;
+    ElementType type;
+    RepresentationId representation;
+    const std::int32_t* labelTable;
+    const std::uint64_t* pathOffsets;
+    const char* pathChars;
+    const unsigned char* dataBlock;
+};
+
+#endif
@@ -0,0 +1,222 @@
+#ifndef FEATUREMATRIX_H
+#define FEATUREMATRIX_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include "dataRepo/Image.h"
+#include "dataRepo/RepresentationTraits.h"
+
+/**
+ * Allocateur aligné utilisé par `FeatureMatrix` pour que chaque bloc de descripteurs
+ * commence sur une ligne de cache.
+ */
+template <typename T, std::size_t Alignment>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * Matrice contiguë des descripteurs d'une représentation.
+ * Tous les descripteurs sont stockés dans un seul buffer aligné, avec un tableau
+ * de labels (et de chemins) parallèle aux lignes.
+ *
+ * En disposition `RowMajor`, la ligne i commence à `data() + i * stride()`.
+ * En disposition `ColumnMajor` (SoA), la colonne j commence à `data() + j * stride()`.
+ * Le stride est arrondi au multiple de `kPadding` supérieur ; le remplissage vaut 0.
+ *
+ * Une matrice peut aussi être une vue sans copie sur un buffer externe (voir `view` et `slice`).
+ * Les lectures (`row`, `data`, `at`) ne copient jamais rien. Les écritures passent par les
+ * accesseurs `mutable*` et `setRow`, qui refusent une vue (`std::logic_error`) : la recopie d'une
+ * vue dans un buffer propre se demande explicitement avec `detach`.
+ *
+ * La copie d'une matrice qui possède ses données copie le buffer ; la copie d'une vue reste une vue.
+ */
+class FeatureMatrix {
+public:
+    enum class Layout { RowMajor, ColumnMajor };
+
+    static constexpr std::size_t kAlignment = 64; // Une ligne de cache.
+    static constexpr std::size_t kPadding = 4;    // 4 doubles = 32 octets.
+
+    using Buffer = std::vector<double, AlignedAllocator<double, kAlignment>>;
+
+    FeatureMatrix();
+
+    /**
+     * Entrée :
+     *   - rows (size_t) : Nombre de lignes (images).
+     *   - dimension (size_t) : Nombre de descripteurs par image.
+     *   - representation (RepresentationId) : Type de représentation (GFD, ART etc).
+     *   - layout (Layout) : Disposition mémoire (par défaut RowMajor).
+     * Sortie : Une matrice remplie de zéros.
+     */
+    FeatureMatrix(std::size_t rows, std::size_t dimension, RepresentationId representation = RepresentationId::Unknown, Layout layout = Layout::RowMajor);
+
+    FeatureMatrix(const FeatureMatrix& other);
+    FeatureMatrix(FeatureMatrix&& other) noexcept;
+    FeatureMatrix& operator=(const FeatureMatrix& other);
+    FeatureMatrix& operator=(FeatureMatrix&& other) noexcept;
+
+    /**
+     * Crée une vue sans copie sur des descripteurs stockés ailleurs (ex. fichier mappé en mémoire).
+     * Entrée :
+     *   - data (const double*) : Début du bloc de descripteurs, disposition RowMajor.
+     *   - rows (size_t) : Nombre de lignes.
+     *   - dimension (size_t) : Nombre de descripteurs par ligne.
+     *   - stride (size_t) : Distance entre deux lignes (en doubles).
+     *   - representation (RepresentationId) : Type de représentation.
+     *   - labels (std::vector<int>) : Labels des lignes.
+     *   - paths (std::vector<std::string>) : Chemins des lignes.
+     *   - owner (std::shared_ptr<const void>) : Objet maintenant `data` en vie tant que la vue existe.
+     * Sortie (FeatureMatrix) : Vue en lecture sur `data`.
+     */
+    static FeatureMatrix view(const double* data, std::size_t rows, std::size_t dimension, std::size_t stride,
+                              RepresentationId representation, std::vector<int> labels,
+                              std::vector<std::string> paths, std::shared_ptr<const void> owner);
+
+    bool isView() const { return borrowed; }
+
+    /**
+     * Recopie les données d'une vue dans un buffer propre (aucun effet si la matrice possède déjà
+     * ses données). À appeler avant les accesseurs `mutable*` sur une matrice qui peut être une vue.
+     */
+    void detach();
+
+    std::size_t rows() const { return numRows; }
+    std::size_t dimension() const { return numCols; }
+    std::size_t stride() const { return rowStride; }
+    Layout layout() const { return memoryLayout; }
+    bool empty() const { return numRows == 0; }
+
+    const double* data() const { return first; }
+    double* mutableData() { requireOwned(); return writable; }
+
+    /**
+     * Accède à une ligne (disposition RowMajor uniquement).
+     * Entrée :
+     *   - i (size_t) : Index de la ligne.
+     * Sortie (const double*) : Pointeur vers les `dimension()` descripteurs de la ligne.
+     */
+    const double* row(std::size_t i) const { return first + i * rowStride; }
+    double* mutableRow(std::size_t i) { requireOwned(); return writable + i * rowStride; }
+
+    /**
+     * Accède à une colonne (disposition ColumnMajor uniquement).
+     * Entrée :
+     *   - j (size_t) : Index de la colonne.
+     * Sortie (const double*) : Pointeur vers les `rows()` valeurs de la colonne.
+     */
+    const double* column(std::size_t j) const { return first + j * rowStride; }
+    double* mutableColumn(std::size_t j) { requireOwned(); return writable + j * rowStride; }
+
+    double at(std::size_t i, std::size_t j) const { return first[offset(i, j)]; }
+
+    int label(std::size_t i) const { return rowLabels[i]; }
+    const std::vector<int>& labels() const { return rowLabels; }
+    void setLabel(std::size_t i, int label) { rowLabels[i] = label; }
+
+    const std::string& path(std::size_t i) const { return rowPaths[i]; }
+    void setPath(std::size_t i, const std::string& path) { rowPaths[i] = path; }
+
+    const std::string& getRepresentationType() const { return representationName(representation); }
+    RepresentationId getRepresentationId() const { return representation; }
+
+    /**
+     * Copie une ligne de descripteurs dans la matrice.
+     * Entrée :
+     *   - i (size_t) : Index de la ligne.
+     *   - descriptors (std::vector<double>&) : Descripteurs (taille `dimension()`).
+     *   - label (int) : Label associé.
+     *   - path (std::string) : Chemin du fichier source.
+     * Sortie : Aucune (`std::logic_error` sur une vue).
+     */
+    void setRow(std::size_t i, const std::vector<double>& descriptors, int label, const std::string& path);
+
+    /**
+     * Reconstruit l'objet `Image` correspondant à une ligne.
+     * Entrée :
+     *   - i (size_t) : Index de la ligne.
+     * Sortie (Image) : Image avec les descripteurs, le label et le chemin de la ligne.
+     */
+    Image toImage(std::size_t i) const;
+
+    /**
+     * Vue sans copie sur les lignes [begin, end) (disposition RowMajor uniquement).
+     * Entrée :
+     *   - begin (size_t) : Première ligne.
+     *   - end (size_t) : Fin (exclue).
+     * Sortie (FeatureMatrix) : Vue en lecture qui partage la propriété du buffer (comme `view`) : elle
+     *   reste valable si cette matrice est déplacée ou détruite, et voit ses écritures ultérieures.
+     */
+    FeatureMatrix slice(std::size_t begin, std::size_t end) const;
+
+    /**
+     * Convertit la matrice dans une autre disposition mémoire.
+     * Entrée :
+     *   - target (Layout) : Disposition voulue.
+     * Sortie (FeatureMatrix) : Copie de la matrice dans la disposition `target`.
+     */
+    FeatureMatrix toLayout(Layout target) const;
+
+private:
+    std::size_t numRows;
+    std::size_t numCols;
+    std::size_t rowStride;
+    Layout memoryLayout;
+    RepresentationId representation;
+    std::shared_ptr<Buffer> storage;      // Buffer propre (partagé avec les tranches), nul pour une vue.
+    std::shared_ptr<const void> owner;    // Vue : maintient en vie les données lues.
+    const double* first;                  // Début des données (propres ou non).
+    double* writable;                     // Début du buffer propre, nul pour une vue.
+    bool borrowed;
+    std::vector<int> rowLabels;
+    std::vector<std::string> rowPaths;
+
+    std::size_t valueCount() const {
+        return rowStride * (memoryLayout == Layout::RowMajor ? numRows : numCols);
+    }
+
+    void requireOwned() const {
+        if (borrowed) {
+            throwBorrowed();
+        }
+    }
+
+    [[noreturn]] static void throwBorrowed();
+
+    void swap(FeatureMatrix& other) noexcept;
+
+    std::size_t offset(std::size_t i, std::size_t j) const {
+        return memoryLayout == Layout::RowMajor ? i * rowStride + j : j * rowStride + i;
+    }
+};
+
+#endif
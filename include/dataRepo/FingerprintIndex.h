@@ -0,0 +1,63 @@
+#ifndef FINGERPRINTINDEX_H
+#define FINGERPRINTINDEX_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Table de hachage à adressage ouvert (sondage linéaire) associant une empreinte 64 bits
+ * à un index dans un stockage externe. Plusieurs index peuvent partager la même empreinte ;
+ * l'égalité réelle est vérifiée par l'appelant.
+ */
+class FingerprintIndex {
+public:
+    FingerprintIndex();
+
+    /**
+     * Cherche un élément déjà indexé.
+     * Entrée :
+     *   - fingerprint (uint64_t) : Empreinte de l'élément cherché.
+     *   - equals (F) : Prédicat `bool(size_t index)` confirmant l'égalité avec l'élément stocké à `index`.
+     * Sortie (bool) :
+     *   - true si un élément égal est présent.
+     *   - false sinon.
+     */
+    template <typename F>
+    bool contains(std::uint64_t fingerprint, F equals) const {
+        if (slots.empty()) return false;
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = fingerprint & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.index == kEmpty) return false;
+            if (slot.fingerprint == fingerprint && equals(slot.index)) return true;
+        }
+    }
+
+    /**
+     * Ajoute un index à la table.
+     * Entrée :
+     *   - fingerprint (uint64_t) : Empreinte de l'élément.
+     *   - index (size_t) : Position de l'élément dans le stockage.
+     * Sortie : Aucune.
+     */
+    void insert(std::uint64_t fingerprint, std::size_t index);
+
+    std::size_t size() const { return count; }
+    void clear();
+
+private:
+    static constexpr std::size_t kEmpty = static_cast<std::size_t>(-1);
+
+    struct Slot {
+        std::uint64_t fingerprint;
+        std::size_t index;
+    };
+
+    std::vector<Slot> slots;
+    std::size_t count;
+
+    void grow();
+};
+
+#endif
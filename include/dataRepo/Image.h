@@ -3,12 +3,14 @@
 
 #include <vector>
 #include <string>
+#include <cstdint>
+#include "dataRepo/RepresentationTraits.h"
 
 class Image {
     private:
     std::vector<double> descripteurs;
     int label;
-    std::string representationType;
+    RepresentationId representation;
     std::string imagePath;
 
 public:
@@ -25,6 +27,16 @@ public:
      */
     Image(const std::vector<double>& descripteurs, int label, const std::string& type, const std::string& path);
 
+    /**
+     * Entrée : 
+     *   - descripteurs (std::vector<double>) : Liste des descripteurs.
+     *   - label (int) : Classe associée.
+     *   - representation (RepresentationId) : Type de représentation.
+     *   - path (std::string) : Accèe à l'image.
+     * Sortie : Un objet `Image` initialisé avec les valeurs fournies.
+     */
+    Image(std::vector<double> descripteurs, int label, RepresentationId representation, std::string path);
+
     /**
      *  Accède aux descripteurs de l'image.
      * Entrée : Aucune.
@@ -41,6 +53,7 @@ public:
 
     int getLabel() const;
     const std::string& getRepresentationType() const;
+    RepresentationId getRepresentationId() const;
     const std::string& getImagePath() const;
 
     /**
@@ -93,6 +106,24 @@ public:
      */
     bool operator<(const Image& other) const;
 
+    /**
+     * Compare le contenu de deux images (label, descripteurs et chemin).
+     * Entrée :
+     *   - other (Image) : L'image à comparer.
+     * Sortie (bool):
+     *   - true si les deux images sont identiques.
+     *   - false sinon.
+     */
+    bool operator==(const Image& other) const;
+
+    /**
+     * Calcule une empreinte 64 bits du contenu de l'image (label, descripteurs et chemin).
+     * Deux images égales ont la même empreinte ; l'inverse n'est pas garanti.
+     * Entrée : Aucune.
+     * Sortie (uint64_t): Empreinte de l'image.
+     */
+    std::uint64_t fingerprint() const;
+
     /**
      * fait un affichage textuelle de l'image.
      * Entrée : Aucune.
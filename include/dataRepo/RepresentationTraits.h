@@ -0,0 +1,105 @@
+#ifndef REPRESENTATIONTRAITS_H
+#define REPRESENTATIONTRAITS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Identifiant compact d'un type de représentation (remplace les chaînes "GFD", "ART" etc).
+ */
+enum class RepresentationId : std::uint8_t {
+    Unknown = 0,
+    GFD,
+    ART,
+    Yang,
+    Zernike7
+};
+
+/**
+ * Caractéristiques d'un type de représentation.
+ */
+struct RepresentationTraits {
+    RepresentationId id;
+    const char* name;       // Nom utilisé dans les sorties et les fichiers binaires.
+    const char* extension;  // Extension des fichiers de descripteurs.
+    std::size_t dimension;  // Nombre de descripteurs par image (0 si inconnu).
+};
+
+constexpr std::size_t kRepresentationCount = 5;
+
+/**
+ * Table des représentations, indexée par `RepresentationId`.
+ */
+constexpr RepresentationTraits kRepresentationTraits[kRepresentationCount] = {
+    {RepresentationId::Unknown,  "UNKNOWN",  "",     0},
+    {RepresentationId::GFD,      "GFD",      ".gfd", 100},
+    {RepresentationId::ART,      "ART",      ".art", 36},
+    {RepresentationId::Yang,     "Yang",     ".yng", 29},
+    {RepresentationId::Zernike7, "Zernike7", ".txt", 18},
+};
+
+constexpr std::size_t representationIndex(RepresentationId id) {
+    return static_cast<std::size_t>(id);
+}
+
+constexpr const RepresentationTraits& representationTraits(RepresentationId id) {
+    return kRepresentationTraits[representationIndex(id)];
+}
+
+constexpr std::size_t representationDimension(RepresentationId id) {
+    return representationTraits(id).dimension;
+}
+
+/**
+ * Dimension d'une représentation connue à la compilation (ex. `kRepresentationDimension<RepresentationId::GFD>`).
+ */
+template <RepresentationId Id>
+constexpr std::size_t kRepresentationDimension = representationDimension(Id);
+
+/**
+ * Retrouve la représentation correspondant à un nombre de descripteurs.
+ * Entrée :
+ *   - dimension (size_t) : Nombre de descripteurs.
+ * Sortie (RepresentationId) : Représentation correspondante, ou Unknown.
+ */
+constexpr RepresentationId representationFromDimension(std::size_t dimension) {
+    for (std::size_t i = 1; i < kRepresentationCount; ++i) {
+        if (kRepresentationTraits[i].dimension == dimension) return kRepresentationTraits[i].id;
+    }
+    return RepresentationId::Unknown;
+}
+
+/**
+ * Retrouve la représentation correspondant à un nom ("GFD", "ART", "Yang", "Zernike7").
+ */
+constexpr RepresentationId representationFromName(std::string_view name) {
+    for (std::size_t i = 1; i < kRepresentationCount; ++i) {
+        if (name == kRepresentationTraits[i].name) return kRepresentationTraits[i].id;
+    }
+    return RepresentationId::Unknown;
+}
+
+/**
+ * Retrouve la représentation correspondant à une extension de fichier (".gfd", ".art" etc).
+ */
+constexpr RepresentationId representationFromExtension(std::string_view extension) {
+    for (std::size_t i = 1; i < kRepresentationCount; ++i) {
+        if (extension == kRepresentationTraits[i].extension) return kRepresentationTraits[i].id;
+    }
+    return RepresentationId::Unknown;
+}
+
+/**
+ * Nom d'une représentation sous forme de chaîne partagée (aucune allocation par appel).
+ * Entrée :
+ *   - id (RepresentationId) : Représentation.
+ * Sortie (const std::string&) : Nom de la représentation.
+ */
+const std::string& representationName(RepresentationId id);
+
+static_assert(representationFromDimension(18) == RepresentationId::Zernike7, "Table des représentations incohérente");
+static_assert(kRepresentationDimension<RepresentationId::GFD> == 100, "Table des représentations incohérente");
+
+#endif
@@ -23,6 +23,14 @@ public:
 
 
     void addPrediction(int trueLabel, int predictedLabel);
+
+    /**
+     * Ajoute les prédictions d'une autre matrice (même nombre de classes).
+     * Entrée :
+     *   - other (ConfusionMatrix&) : Matrice à fusionner, ex. celle d'un autre thread.
+     * Sortie : Aucune.
+     */
+    void merge(const ConfusionMatrix& other);
     void printMatrix() const;
     const std::vector<std::vector<int>>& getMatrix() const;
 
@@ -0,0 +1,59 @@
+#ifndef PARALLELEVALUATOR_H
+#define PARALLELEVALUATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "dataRepo/FeatureMatrix.h"
+#include "evaluation/ConfusionMatrix.h"
+#include "parallel/ThreadPool.h"
+
+/**
+ * Résultat de l'évaluation d'un prédicteur sur un ensemble de test.
+ */
+struct EvaluationResult {
+    ConfusionMatrix confusionMatrix;
+    std::vector<int> trueLabels;          // Dans l'ordre des requêtes.
+    std::vector<double> confidenceScores; // Dans l'ordre des requêtes.
+
+    explicit EvaluationResult(int numClasses) : confusionMatrix(numClasses) {}
+};
+
+/**
+ * Évalue un prédicteur sur toutes les requêtes d'une matrice en répartissant des tranches de
+ * requêtes sur un pool de threads. Chaque thread remplit sa propre matrice de confusion ; les
+ * matrices sont fusionnées à la fin. Les scores de confiance sont rangés à l'index de leur requête :
+ * le résultat ne dépend ni du nombre de threads ni de l'ordre d'exécution.
+ */
+class ParallelEvaluator {
+public:
+    /**
+     * Prédit (label, confiance) pour chaque ligne d'une tranche de requêtes. Doit pouvoir être
+     * appelé depuis plusieurs threads à la fois (les prédicteurs `const` le peuvent).
+     */
+    using BatchPredictor = std::function<std::vector<std::pair<int, double>>(const FeatureMatrix& queries)>;
+
+    /**
+     * Entrée :
+     *   - pool (ThreadPool&) : Pool utilisé (par défaut le pool partagé).
+     *   - shardSize (size_t) : Nombre de requêtes par tranche.
+     * Sortie : Un évaluateur.
+     */
+    explicit ParallelEvaluator(ThreadPool& pool = ThreadPool::shared(), std::size_t shardSize = 32);
+
+    /**
+     * Entrée :
+     *   - queries (FeatureMatrix&) : Requêtes (disposition RowMajor) et leurs vrais labels.
+     *   - numClasses (int) : Nombre de classes de la matrice de confusion.
+     *   - predict (BatchPredictor) : Prédicteur.
+     * Sortie (EvaluationResult) : Matrice de confusion, vrais labels et scores de confiance.
+     */
+    EvaluationResult evaluate(const FeatureMatrix& queries, int numClasses, const BatchPredictor& predict) const;
+
+private:
+    ThreadPool& pool;
+    std::size_t shardSize;
+};
+
+#endif
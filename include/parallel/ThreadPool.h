@@ -0,0 +1,86 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * Pool de threads persistant pour paralléliser des boucles indépendantes.
+ * Le thread appelant participe toujours au travail, ce qui permet d'appeler
+ * `parallelFor` depuis une tâche du même pool sans interblocage.
+ */
+class ThreadPool {
+public:
+    /**
+     * Entrée :
+     *   - numThreads (size_t) : Nombre total de threads, appelant compris (0 = nombre de cœurs).
+     * Sortie : Un pool avec `numThreads - 1` threads auxiliaires.
+     */
+    explicit ThreadPool(std::size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Nombre maximal de threads travaillant sur un même `parallelFor`.
+     */
+    std::size_t size() const { return numWorkers; }
+
+    /**
+     * Exécute `task(index, worker)` pour chaque index de [0, count).
+     * Entrée :
+     *   - count (size_t) : Nombre de tâches.
+     *   - task (std::function) : Tâche ; `worker` est dans [0, size()) et unique parmi les
+     *     threads exécutant simultanément ce `parallelFor` (utile pour des buffers par thread).
+     * Sortie : Aucune. Retourne quand toutes les tâches sont terminées ; la première
+     *          exception levée par une tâche est relancée dans l'appelant.
+     */
+    void parallelFor(std::size_t count, const std::function<void(std::size_t index, std::size_t worker)>& task);
+
+    /**
+     * Nombre de threads par défaut (nombre de cœurs, au moins 1).
+     */
+    static std::size_t defaultThreadCount();
+
+    /**
+     * Pool partagé par tout le programme, dimensionné sur le nombre de cœurs.
+     */
+    static ThreadPool& shared();
+
+    /**
+     * Pool sans thread auxiliaire : `parallelFor` s'exécute dans l'appelant.
+     */
+    static ThreadPool& sequential();
+
+    /**
+     * Choisit le pool d'une opération sans créer de threads à chaque appel.
+     * Entrée :
+     *   - numThreads (size_t) : Nombre de threads demandé (0 = nombre de cœurs).
+     *   - owned (std::unique_ptr<ThreadPool>&) : Pool propre de l'appelant, créé (ou recréé si sa
+     *     taille diffère) seulement pour un nombre de threads supérieur à 1.
+     * Sortie (ThreadPool&) : `shared()` pour 0, `sequential()` pour 1, `*owned` sinon.
+     */
+    static ThreadPool& select(std::size_t numThreads, std::unique_ptr<ThreadPool>& owned);
+
+private:
+    struct Job;
+
+    std::size_t numWorkers;
+    std::vector<std::thread> helpers;
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    bool stopping;
+
+    void helperLoop();
+    static void runJob(Job& job, std::size_t worker);
+};
+
+#endif
@@ -0,0 +1,187 @@
+#include "classifier/HNSWIndex.h"
+#include "classifier/KNNClassifier.h"
+#include "classifier/PQIndex.h"
+#include "classifier/IVFIndex.h"
+#include "classifier/TopKSelector.h"
+#include "dataRepo/DataCollection.h"
+#include "dataRepo/FeatureMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <filesystem>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Neighbors = std::vector<std::pair<double, int>>;
+
+/**
+ * Rapport rappel / latence des index approchés (HNSW, PQ, IVF) face à la recherche exhaustive sur le
+ * découpage train2 / test2 d'une représentation (GFD par défaut), après normalisation comme dans main.
+ * `copies` > 1 ajoute des lignes interpolées entre lignes d'entraînement de même label pour
+ * simuler un jeu de référence plus grand. Le rappel@K est la part des K voisins rendus par HNSW dont la distance
+ * ne dépasse pas celle du K-ième vrai voisin.
+ * Usage : bench_ann [représentation = data/=Signatures/=GFD] [k = 12] [copies = 1]
+ */
+
+bool loadSplit(const std::string& dir, DataCollection& collection) {
+    if (fs::exists(dir + ".rfds")) {
+        return collection.loadDatasetFromStore(dir + ".rfds");
+    }
+    return collection.loadDatasetFromDirectory(dir);
+}
+
+FeatureMatrix augment(const FeatureMatrix& train, std::size_t copies, std::mt19937& gen) {
+    // Chaque ligne ajoutée est un point aléatoire du segment entre deux lignes de même label.
+    std::vector<std::vector<std::size_t>> rowsByLabel;
+    for (std::size_t i = 0; i < train.rows(); ++i) {
+        std::size_t label = static_cast<std::size_t>(std::max(0, train.label(i)));
+        if (rowsByLabel.size() <= label) rowsByLabel.resize(label + 1);
+        rowsByLabel[label].push_back(i);
+    }
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    const std::size_t dimension = train.dimension();
+    FeatureMatrix result(train.rows() * copies, dimension, train.getRepresentationId());
+    for (std::size_t c = 0; c < copies; ++c) {
+        for (std::size_t i = 0; i < train.rows(); ++i) {
+            const std::vector<std::size_t>& sameLabel = rowsByLabel[static_cast<std::size_t>(std::max(0, train.label(i)))];
+            const double* a = train.row(i);
+            const double* b = train.row(sameLabel[std::uniform_int_distribution<std::size_t>(0, sameLabel.size() - 1)(gen)]);
+            const double t = (c == 0) ? 0.0 : position(gen);
+            double* target = result.mutableRow(c * train.rows() + i);
+            for (std::size_t j = 0; j < dimension; ++j) {
+                target[j] = a[j] + t * (b[j] - a[j]);
+            }
+            result.setLabel(c * train.rows() + i, train.label(i));
+        }
+    }
+    return result;
+}
+
+double recallAtK(const Neighbors& truth, const Neighbors& found) {
+    if (truth.empty()) return 1.0;
+    const double kth = truth.back().first;
+    std::size_t hits = 0;
+    for (const auto& neighbor : found) {
+        if (neighbor.first <= kth) ++hits;
+    }
+    return static_cast<double>(std::min(hits, truth.size())) / truth.size();
+}
+
+/**
+ * Mesure le rappel@K et la latence moyenne d'un index pour chaque valeur de son paramètre de recherche.
+ */
+void report(const NeighborIndex& index, const std::string& knob, const std::vector<std::size_t>& values,
+            const std::function<void(std::size_t)>& setKnob, const FeatureMatrix& queries,
+            const std::vector<Neighbors>& truth, const DistancePolicy& policy, int k, std::size_t passes,
+            double bruteMicros) {
+    std::cout << std::left << std::setw(14) << knob << std::setw(12) << "Rappel@K"
+              << std::setw(18) << "Latence (us)" << "Gain" << std::endl;
+    TopKSelector selector;
+    Neighbors found;
+    const std::size_t numQueries = queries.rows();
+    for (std::size_t value : values) {
+        setKnob(value);
+        double recall = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t p = 0; p < passes; ++p) {
+            recall = 0.0;
+            for (std::size_t q = 0; q < numQueries; ++q) {
+                selector.reset(static_cast<std::size_t>(k));
+                index.search(queries.row(q), selector);
+                selector.finish(found);
+                for (auto& neighbor : found) {
+                    neighbor.first = policy.finalize(neighbor.first);
+                }
+                recall += recallAtK(truth[q], found);
+            }
+        }
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                      / (passes * numQueries);
+        std::cout << std::setw(14) << value << std::setw(12) << recall / numQueries
+                  << std::setw(18) << micros << "x" << bruteMicros / micros << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string representationDir = argc > 1 ? argv[1] : "data/=Signatures/=GFD";
+    int k = argc > 2 ? std::stoi(argv[2]) : 12;
+    std::size_t copies = argc > 3 ? std::max<std::size_t>(1, std::stoul(argv[3])) : 1;
+
+    DataCollection trainDataset, testDataset;
+    if (!loadSplit(representationDir + "/train2", trainDataset) || !loadSplit(representationDir + "/test2", testDataset)) {
+        std::cerr << "Erreur : Impossible de charger " << representationDir << std::endl;
+        return 1;
+    }
+    std::vector<Image> trainImages = trainDataset.getImages();
+    std::vector<Image> testImages = testDataset.getImages();
+    trainDataset.computeNormalizationBounds(trainImages);
+    trainDataset.normalizeDataset(trainImages);
+    trainDataset.normalizeDataset(testImages);
+
+    std::mt19937 gen(42);
+    FeatureMatrix train = augment(DataCollection::buildFeatureMatrix(trainImages), copies, gen);
+    FeatureMatrix queries = DataCollection::buildFeatureMatrix(testImages);
+    const std::size_t numQueries = queries.rows();
+    // Plusieurs passes sur les requêtes pour des latences mesurables.
+    const std::size_t passes = std::max<std::size_t>(1, 2000 / std::max<std::size_t>(1, numQueries));
+
+    KNNIndexOptions bruteForce;
+    bruteForce.backend = KNNIndexOptions::Backend::BruteForce;
+    KNNClassifier exact(train, k, "euclidean", bruteForce);
+
+    std::vector<Neighbors> truth(numQueries);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < passes; ++p) {
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            truth[q] = exact.findKNearestNeighbors(queries.toImage(q));
+        }
+    }
+    double bruteMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+                       / (passes * numQueries);
+
+    std::cout << representationDir << " : " << train.rows() << " lignes x " << train.dimension() << ", "
+              << numQueries << " requêtes, K = " << k << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Force brute : " << bruteMicros << " us/requête" << std::endl;
+
+    DistancePolicy policy(DistanceMetric::Euclidean, train.dimension());
+    const std::size_t kValue = static_cast<std::size_t>(k);
+
+    HNSWParameters hnswParameters;
+    start = std::chrono::steady_clock::now();
+    HNSWIndex hnsw(train, policy, hnswParameters);
+    double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::endl << "HNSW (M = " << hnswParameters.M << ", efConstruction = " << hnswParameters.efConstruction
+              << ") : construction " << buildSeconds * 1e3 << " ms, niveau max " << hnsw.maxLevel() << std::endl;
+    report(hnsw, "efSearch", {kValue, 2 * kValue, 4 * kValue, 8 * kValue, 16 * kValue, 32 * kValue},
+           [&hnsw](std::size_t ef) { hnsw.setEfSearch(ef); }, queries, truth, policy, k, passes, bruteMicros);
+
+    PQParameters pqParameters;
+    start = std::chrono::steady_clock::now();
+    PQIndex pq(train, policy, pqParameters);
+    buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double rawBytes = static_cast<double>(train.rows() * train.dimension() * sizeof(double));
+    std::cout << std::endl << "PQ (" << pq.subspaceCount() << " octets par ligne) : construction " << buildSeconds * 1e3
+              << " ms, " << pq.compressedBytes() / 1024.0 << " Ko au lieu de " << rawBytes / 1024.0
+              << " Ko (x" << rawBytes / pq.compressedBytes() << ")" << std::endl;
+    report(pq, "rerankFactor", {1, 2, 5, 10, 20, 50},
+           [&pq](std::size_t factor) { pq.setRerankFactor(factor); }, queries, truth, policy, k, passes, bruteMicros);
+
+    IVFParameters ivfParameters;
+    start = std::chrono::steady_clock::now();
+    IVFIndex ivf(train, policy, ivfParameters);
+    buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::endl << "IVF (" << ivf.listCount() << " listes) : construction " << buildSeconds * 1e3 << " ms" << std::endl;
+    std::vector<std::size_t> probes;
+    for (std::size_t p = 1; p < ivf.listCount(); p *= 2) {
+        probes.push_back(p);
+    }
+    probes.push_back(ivf.listCount());
+    report(ivf, "nprobe", probes,
+           [&ivf](std::size_t value) { ivf.setNprobe(value); }, queries, truth, policy, k, passes, bruteMicros);
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "classifier/DistanceKernels.h"
+#include "dataRepo/RepresentationTraits.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Compare, pour chaque représentation, le noyau scalaire générique (référence) et les noyaux
+ * spécialisés sur la dimension pour chaque jeu d'instructions supporté, en double et en float
+ * (balayage de chaque requête contre toutes les lignes d'une matrice aléatoire).
+ * Usage : bench_distances [lignes = 20000] [requêtes = 200]
+ */
+
+using Isa = DistanceKernels::InstructionSet;
+
+template <typename T>
+using KernelOf = double (*)(const T*, const T*, std::size_t);
+
+template <typename T>
+struct Sample {
+    std::size_t rows;
+    std::size_t stride;
+    std::vector<T> values;
+    const T* row(std::size_t i) const { return values.data() + i * stride; }
+};
+
+template <typename T>
+Sample<T> randomSample(std::size_t rows, std::size_t dimension, std::mt19937& gen) {
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+    Sample<T> sample{rows, dimension, std::vector<T>(rows * dimension)};
+    for (T& v : sample.values) {
+        v = static_cast<T>(value(gen));
+    }
+    return sample;
+}
+
+template <typename T>
+double scan(KernelOf<T> kernel, const Sample<T>& data, const Sample<T>& queries, std::size_t dimension, double& seconds) {
+    double checksum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t q = 0; q < queries.rows; ++q) {
+        for (std::size_t i = 0; i < data.rows; ++i) {
+            checksum += kernel(queries.row(q), data.row(i), dimension);
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return checksum;
+}
+
+template <typename T>
+void benchRepresentation(const std::string& name, std::size_t dimension, const std::vector<Isa>& isas,
+                         std::size_t rows, std::size_t numQueries, std::mt19937& gen) {
+    Sample<T> data = randomSample<T>(rows, dimension, gen);
+    Sample<T> queries = randomSample<T>(numQueries, dimension, gen);
+    double pairs = static_cast<double>(rows) * numQueries;
+
+    for (int metric = 0; metric < 2; ++metric) {
+        KernelOf<T> reference = metric == 0 ? static_cast<KernelOf<T>>(&DistanceKernels::squaredEuclidean)
+                                            : static_cast<KernelOf<T>>(&DistanceKernels::manhattan);
+        double referenceSeconds;
+        double referenceSum = scan<T>(reference, data, queries, dimension, referenceSeconds);
+
+        std::cout << std::left << std::setw(20) << (name + (metric == 0 ? " L2" : " L1")) << std::setw(6) << dimension
+                  << std::fixed << std::setprecision(2) << std::setw(12) << referenceSeconds * 1e9 / pairs;
+
+        bool identical = true;
+        for (Isa isa : isas) {
+            KernelOf<T> kernel;
+            if constexpr (std::is_same<T, double>::value) {
+                kernel = metric == 0 ? DistanceKernels::squaredEuclideanKernel(dimension, isa)
+                                     : DistanceKernels::manhattanKernel(dimension, isa);
+            } else {
+                kernel = metric == 0 ? DistanceKernels::squaredEuclideanFloatKernel(dimension, isa)
+                                     : DistanceKernels::manhattanFloatKernel(dimension, isa);
+            }
+            double seconds;
+            identical = identical && scan<T>(kernel, data, queries, dimension, seconds) == referenceSum;
+            std::cout << std::setw(6) << seconds * 1e9 / pairs << "x" << std::setw(7) << referenceSeconds / seconds;
+        }
+        std::cout << (identical ? "" : "  (résultats différents !)") << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t rows = argc > 1 ? std::stoul(argv[1]) : 20000;
+    std::size_t numQueries = argc > 2 ? std::stoul(argv[2]) : 200;
+    std::mt19937 gen(42);
+
+    std::vector<Isa> isas;
+    for (Isa isa : {Isa::Scalar, Isa::SSE2, Isa::AVX2, Isa::AVX512}) {
+        if (DistanceKernels::isSupported(isa)) {
+            isas.push_back(isa);
+        }
+    }
+
+    std::cout << "Jeu d'instructions détecté : "
+              << DistanceKernels::instructionSetName(DistanceKernels::detectInstructionSet()) << std::endl;
+    std::cout << "Temps en ns par paire (gain par rapport au scalaire générique)" << std::endl;
+    std::cout << std::left << std::setw(20) << "Repr." << std::setw(6) << "Dim" << std::setw(12) << "Générique";
+    for (Isa isa : isas) {
+        std::cout << std::setw(14) << DistanceKernels::instructionSetName(isa);
+    }
+    std::cout << std::endl;
+
+    for (std::size_t r = 1; r < kRepresentationCount; ++r) {
+        const RepresentationTraits& traits = kRepresentationTraits[r];
+        benchRepresentation<double>(std::string(traits.name) + " double", traits.dimension, isas, rows, numQueries, gen);
+        benchRepresentation<float>(std::string(traits.name) + " float", traits.dimension, isas, rows, numQueries, gen);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "classifier/KNNClassifier.h"
+#include "classifier/KNNGraph.h"
+#include "classifier/TopKSelector.h"
+#include "dataRepo/DataCollection.h"
+#include "dataRepo/FeatureMatrix.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Construit le graphe des K plus proches voisins du découpage train2 d'une représentation (après
+ * normalisation comme dans main), le compare à une recherche exhaustive ligne par ligne qui ne
+ * profite pas de la symétrie, vérifie l'aller-retour par fichier, puis s'en sert pour une évaluation
+ * leave-one-out et un comptage des doublons (voisins à distance nulle).
+ * Usage : bench_graph [représentation = data/=Signatures/=GFD] [k = 12] [distance = euclidean]
+ */
+
+bool loadSplit(const std::string& dir, DataCollection& collection) {
+    if (fs::exists(dir + ".rfds")) {
+        return collection.loadDatasetFromStore(dir + ".rfds");
+    }
+    return collection.loadDatasetFromDirectory(dir);
+}
+
+int main(int argc, char* argv[]) {
+    std::string representationDir = argc > 1 ? argv[1] : "data/=Signatures/=GFD";
+    std::size_t k = argc > 2 ? std::stoul(argv[2]) : 12;
+    std::string distance = argc > 3 ? argv[3] : "euclidean";
+
+    DataCollection trainDataset;
+    if (!loadSplit(representationDir + "/train2", trainDataset)) {
+        std::cerr << "Erreur : Impossible de charger " << representationDir << std::endl;
+        return 1;
+    }
+    std::vector<Image> trainImages = trainDataset.getImages();
+    trainDataset.computeNormalizationBounds(trainImages);
+    trainDataset.normalizeDataset(trainImages);
+    FeatureMatrix train = DataCollection::buildFeatureMatrix(trainImages);
+    const std::size_t rows = train.rows();
+    const DistancePolicy policy(distanceMetricFromName(distance), train.dimension());
+
+    KNNIndexOptions bruteForce;
+    bruteForce.backend = KNNIndexOptions::Backend::BruteForce;
+    KNNClassifier knn(train, static_cast<int>(k), distance, bruteForce);
+
+    auto start = std::chrono::steady_clock::now();
+    KNNGraph graph = knn.buildNeighborGraph(k);
+    double graphSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    TopKSelector selector;
+    std::vector<TopKSelector::Neighbor> expected;
+    std::size_t mismatches = 0;
+    for (std::size_t i = 0; i < rows; ++i) {
+        selector.reset(graph.neighborCount());
+        for (std::size_t j = 0; j < rows; ++j) {
+            if (j != i) {
+                selector.push(policy.rank(train.row(i), train.row(j)), static_cast<int>(j));
+            }
+        }
+        selector.finish(expected);
+        bool same = expected.size() == graph.degree(i);
+        for (std::size_t j = 0; same && j < expected.size(); ++j) {
+            same = graph.neighbors(i)[j] == static_cast<std::uint32_t>(expected[j].second)
+                && graph.distances(i)[j] == policy.finalize(expected[j].first);
+        }
+        mismatches += same ? 0 : 1;
+    }
+    double naiveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << rows << " lignes, dimension " << train.dimension() << ", K = " << graph.neighborCount()
+              << ", " << distance << std::endl;
+    std::cout << "Graphe par tuiles symétriques : " << graphSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Recherche exhaustive par ligne : " << naiveSeconds * 1000.0 << " ms (x"
+              << naiveSeconds / graphSeconds << ")" << std::endl;
+    std::cout << "Lignes différentes : " << mismatches << std::endl;
+
+    const std::string graphPath = (fs::temp_directory_path() / "bench_graph.rfknn").string();
+    KNNGraph reloaded;
+    if (!graph.save(graphPath) || !reloaded.load(graphPath)) {
+        return 1;
+    }
+    bool roundTrip = reloaded.rows() == rows && reloaded.edgeCount() == graph.edgeCount()
+        && reloaded.metric() == graph.metric() && reloaded.getRepresentationId() == graph.getRepresentationId();
+    for (std::size_t i = 0; roundTrip && i < rows; ++i) {
+        roundTrip = reloaded.label(i) == graph.label(i) && reloaded.degree(i) == graph.degree(i)
+            && std::equal(graph.neighbors(i), graph.neighbors(i) + graph.degree(i), reloaded.neighbors(i))
+            && std::equal(graph.distances(i), graph.distances(i) + graph.degree(i), reloaded.distances(i));
+    }
+    std::cout << "Fichier : " << fs::file_size(graphPath) << " octets, relecture "
+              << (roundTrip ? "identique" : "DIFFÉRENTE") << std::endl;
+    std::remove(graphPath.c_str());
+
+    // Leave-one-out : vote majoritaire des K voisins, à égalité le premier label à atteindre le maximum.
+    std::size_t correct = 0;
+    std::size_t duplicates = 0;
+    std::vector<int> votes;
+    for (std::size_t i = 0; i < rows; ++i) {
+        votes.assign(votes.size(), 0);
+        int best = -1;
+        int bestVotes = 0;
+        for (std::size_t j = 0; j < reloaded.degree(i); ++j) {
+            int label = reloaded.label(reloaded.neighbors(i)[j]);
+            if (label < 0) continue;
+            if (static_cast<std::size_t>(label) >= votes.size()) votes.resize(label + 1, 0);
+            if (++votes[label] > bestVotes) {
+                bestVotes = votes[label];
+                best = label;
+            }
+        }
+        correct += best == reloaded.label(i) ? 1 : 0;
+        duplicates += reloaded.degree(i) > 0 && reloaded.distances(i)[0] == 0.0 ? 1 : 0;
+    }
+    std::cout << "Précision leave-one-out : " << static_cast<double>(correct) / rows << std::endl;
+    std::cout << "Lignes ayant un doublon : " << duplicates << std::endl;
+    return mismatches == 0 && roundTrip ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+#include "classifier/KMeans.h"
+#include "dataRepo/DataCollection.h"
+#include "dataRepo/DescriptorStore.h"
+#include "dataRepo/FeatureMatrix.h"
+#include "parallel/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Compare les initialisations de `KMeans` (tirage uniforme, k-means++, k-means||) sur le découpage
+ * train2 d'une représentation, après normalisation comme dans main : itérations de Lloyd, inertie
+ * finale et durée moyenne d'entraînement sur plusieurs graines. Vérifie aussi qu'une même graine
+ * redonne les mêmes centroids. Compare ensuite les assignations Lloyd, Hamerly et Elkan pour
+ * plusieurs nombres de clusters (durée, distances calculées, depuis une initialisation uniforme) et
+ * vérifie que leurs centroids sont identiques, puis que le nombre de threads ne change pas les
+ * centroids (durée et accélération par nombre de threads), et que `nInit` garde le meilleur des
+ * entraînements lancés en parallèle. Compare enfin `fit` à `fitStream` (mini-lots lus depuis
+ * un fichier binaire temporaire) pour plusieurs tailles de lot. `copies` > 1 ajoute des lignes
+ * interpolées entre lignes de même label.
+ * Usage : bench_kmeans [représentation = data/=Signatures/=GFD] [clusters = 10] [graines = 10] [copies = 1]
+ */
+
+bool loadSplit(const std::string& dir, DataCollection& collection) {
+    if (fs::exists(dir + ".rfds")) {
+        return collection.loadDatasetFromStore(dir + ".rfds");
+    }
+    return collection.loadDatasetFromDirectory(dir);
+}
+
+FeatureMatrix augment(const FeatureMatrix& train, std::size_t copies, std::mt19937& gen) {
+    // Chaque ligne ajoutée est un point aléatoire du segment entre deux lignes de même label.
+    std::vector<std::vector<std::size_t>> rowsByLabel;
+    for (std::size_t i = 0; i < train.rows(); ++i) {
+        std::size_t label = static_cast<std::size_t>(std::max(0, train.label(i)));
+        if (rowsByLabel.size() <= label) rowsByLabel.resize(label + 1);
+        rowsByLabel[label].push_back(i);
+    }
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    const std::size_t dimension = train.dimension();
+    FeatureMatrix result(train.rows() * copies, dimension, train.getRepresentationId());
+    for (std::size_t c = 0; c < copies; ++c) {
+        for (std::size_t i = 0; i < train.rows(); ++i) {
+            const std::vector<std::size_t>& sameLabel = rowsByLabel[static_cast<std::size_t>(std::max(0, train.label(i)))];
+            const double* a = train.row(i);
+            const double* b = train.row(sameLabel[std::uniform_int_distribution<std::size_t>(0, sameLabel.size() - 1)(gen)]);
+            const double t = (c == 0) ? 0.0 : position(gen);
+            double* target = result.mutableRow(c * train.rows() + i);
+            for (std::size_t j = 0; j < dimension; ++j) {
+                target[j] = a[j] + t * (b[j] - a[j]);
+            }
+            result.setLabel(c * train.rows() + i, train.label(i));
+        }
+    }
+    return result;
+}
+
+bool sameCentroids(const FeatureMatrix& a, const FeatureMatrix& b) {
+    if (a.rows() != b.rows() || a.dimension() != b.dimension()) return false;
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        if (!std::equal(a.row(i), a.row(i) + a.dimension(), b.row(i))) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string representationDir = argc > 1 ? argv[1] : "data/=Signatures/=GFD";
+    int clusters = argc > 2 ? std::stoi(argv[2]) : 10;
+    std::size_t seeds = argc > 3 ? std::stoul(argv[3]) : 10;
+    std::size_t copies = argc > 4 ? std::stoul(argv[4]) : 1;
+
+    DataCollection trainDataset;
+    if (!loadSplit(representationDir + "/train2", trainDataset)) {
+        std::cerr << "Erreur : Impossible de charger " << representationDir << std::endl;
+        return 1;
+    }
+    std::vector<Image> trainImages = trainDataset.getImages();
+    trainDataset.computeNormalizationBounds(trainImages);
+    trainDataset.normalizeDataset(trainImages);
+    std::mt19937 gen(42);
+    FeatureMatrix train = augment(DataCollection::buildFeatureMatrix(trainImages), std::max<std::size_t>(1, copies), gen);
+    const RepresentationId representation = train.getRepresentationId();
+
+    std::cout << train.rows() << " lignes, dimension " << train.dimension() << ", " << clusters << " clusters, "
+              << seeds << " graines" << std::endl;
+    std::cout << std::left << std::setw(18) << "Initialisation" << std::setw(14) << "Itérations"
+              << std::setw(16) << "Inertie moy." << std::setw(16) << "Inertie min" << std::setw(16) << "Inertie max"
+              << std::setw(14) << "Durée (ms)" << "Reproductible" << std::endl;
+
+    const std::pair<KMeansOptions::Init, const char*> inits[] = {
+        {KMeansOptions::Init::Random, "Uniforme"},
+        {KMeansOptions::Init::KMeansPlusPlus, "k-means++"},
+        {KMeansOptions::Init::KMeansParallel, "k-means||"},
+    };
+    bool ok = true;
+    for (const auto& init : inits) {
+        double iterations = 0.0;
+        double inertiaSum = 0.0;
+        double inertiaMin = std::numeric_limits<double>::infinity();
+        double inertiaMax = 0.0;
+        double seconds = 0.0;
+        bool reproducible = true;
+        for (std::size_t s = 0; s < seeds; ++s) {
+            KMeansOptions options;
+            options.init = init.first;
+            options.seed = s + 1;
+            KMeans kmeans(clusters, static_cast<int>(train.dimension()), 100, 1e-4, options);
+            auto start = std::chrono::steady_clock::now();
+            kmeans.fit(train);
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            iterations += kmeans.getIterations(representation);
+            const double inertia = kmeans.getInertia(representation);
+            inertiaSum += inertia;
+            inertiaMin = std::min(inertiaMin, inertia);
+            inertiaMax = std::max(inertiaMax, inertia);
+
+            KMeans again(clusters, static_cast<int>(train.dimension()), 100, 1e-4, options);
+            again.fit(train);
+            reproducible = reproducible && sameCentroids(kmeans.getCentroids(representation), again.getCentroids(representation));
+        }
+        std::cout << std::setw(18) << init.second << std::setw(14) << iterations / seeds
+                  << std::setw(16) << inertiaSum / seeds << std::setw(16) << inertiaMin << std::setw(16) << inertiaMax
+                  << std::setw(14) << seconds * 1000.0 / seeds << (reproducible ? "oui" : "NON") << std::endl;
+        ok = ok && reproducible;
+    }
+
+    std::cout << std::endl << std::setw(10) << "Clusters" << std::setw(12) << "Algorithme" << std::setw(14) << "Itérations"
+              << std::setw(14) << "Durée (ms)" << std::setw(22) << "Distances calculées" << "Centroids" << std::endl;
+    const std::pair<KMeansOptions::Algorithm, const char*> algorithms[] = {
+        {KMeansOptions::Algorithm::Lloyd, "Lloyd"},
+        {KMeansOptions::Algorithm::Hamerly, "Hamerly"},
+        {KMeansOptions::Algorithm::Elkan, "Elkan"},
+    };
+    for (int factor : {1, 4, 16}) {
+        const int count = std::min(clusters * factor, static_cast<int>(train.rows()));
+        FeatureMatrix reference;
+        std::size_t lloydEvaluations = 0;
+        for (const auto& algorithm : algorithms) {
+            // Initialisation uniforme : la durée mesurée est surtout celle des itérations.
+            KMeansOptions options;
+            options.init = KMeansOptions::Init::Random;
+            options.algorithm = algorithm.first;
+            KMeans kmeans(count, static_cast<int>(train.dimension()), 100, 1e-4, options);
+            auto start = std::chrono::steady_clock::now();
+            kmeans.fit(train);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            const std::size_t evaluations = kmeans.getDistanceEvaluations(representation);
+            bool same = true;
+            if (algorithm.first == KMeansOptions::Algorithm::Lloyd) {
+                reference = kmeans.getCentroids(representation);
+                lloydEvaluations = evaluations;
+            } else {
+                same = sameCentroids(reference, kmeans.getCentroids(representation));
+            }
+            std::cout << std::setw(10) << count << std::setw(12) << algorithm.second
+                      << std::setw(14) << kmeans.getIterations(representation) << std::setw(14) << seconds * 1000.0
+                      << std::setw(22) << (std::to_string(evaluations) + " ("
+                                           + std::to_string(100 * evaluations / std::max<std::size_t>(1, lloydEvaluations)) + "%)")
+                      << (same ? "identiques" : "DIFFÉRENTS") << std::endl;
+            ok = ok && same;
+        }
+    }
+
+    // Threads : même entraînement (Elkan, clusters x 4) avec 1, 2, 4... threads ; les centroids doivent être identiques.
+    std::cout << std::endl << std::setw(10) << "Threads" << std::setw(14) << "Durée (ms)" << std::setw(16) << "Accélération"
+              << "Centroids" << std::endl;
+    const int threadClusters = std::min(clusters * 4, static_cast<int>(train.rows()));
+    FeatureMatrix sequentialCentroids;
+    double sequentialSeconds = 0.0;
+    for (std::size_t threads = 1; threads <= std::max<std::size_t>(4, ThreadPool::defaultThreadCount()); threads *= 2) {
+        KMeansOptions options;
+        options.algorithm = KMeansOptions::Algorithm::Elkan;
+        options.numThreads = threads;
+        KMeans kmeans(threadClusters, static_cast<int>(train.dimension()), 100, 1e-4, options);
+        auto start = std::chrono::steady_clock::now();
+        kmeans.fit(train);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        bool same = true;
+        if (threads == 1) {
+            sequentialCentroids = kmeans.getCentroids(representation);
+            sequentialSeconds = seconds;
+        } else {
+            same = sameCentroids(sequentialCentroids, kmeans.getCentroids(representation));
+        }
+        std::cout << std::setw(10) << threads << std::setw(14) << seconds * 1000.0
+                  << std::setw(15) << sequentialSeconds / seconds << (same ? "identiques" : "DIFFÉRENTS") << std::endl;
+        ok = ok && same;
+    }
+
+    // Redémarrages : nInit entraînements en parallèle ; le modèle gardé doit être celui du meilleur
+    // entraînement seul parmi les mêmes graines.
+    std::cout << std::endl << std::setw(10) << "nInit" << std::setw(17) << "Inertie gardée" << std::setw(16) << "Inertie max"
+              << std::setw(14) << "Itérations" << std::setw(14) << "Durée (ms)" << "Meilleur seul" << std::endl;
+    for (std::size_t restarts : {std::size_t(1), std::size_t(4), std::max<std::size_t>(1, seeds)}) {
+        KMeansOptions options;
+        options.init = KMeansOptions::Init::Random;
+        options.nInit = restarts;
+        KMeans kmeans(clusters, static_cast<int>(train.dimension()), 100, 1e-4, options);
+        auto start = std::chrono::steady_clock::now();
+        kmeans.fit(train);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const std::vector<KMeansRestart>& summaries = kmeans.getRestarts(representation);
+        const KMeansRestart& kept = summaries[kmeans.getBestRestart(representation)];
+        double worst = 0.0;
+        for (const KMeansRestart& summary : summaries) worst = std::max(worst, summary.inertia);
+
+        KMeansOptions single = options;
+        single.nInit = 1;
+        single.seed = kept.seed;
+        KMeans alone(clusters, static_cast<int>(train.dimension()), 100, 1e-4, single);
+        alone.fit(train);
+        const bool same = summaries.size() == restarts && kept.inertia == kmeans.getInertia(representation)
+                       && sameCentroids(alone.getCentroids(representation), kmeans.getCentroids(representation));
+        std::cout << std::setw(10) << restarts << std::setw(16) << kept.inertia << std::setw(16) << worst
+                  << std::setw(14) << kept.iterations << std::setw(14) << seconds * 1000.0 << (same ? "oui" : "NON") << std::endl;
+        ok = ok && same;
+    }
+
+    // Mini-lots : les lignes sont mélangées avant l'écriture, chaque lot couvre alors toutes les classes.
+    std::vector<std::size_t> order(train.rows());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), gen);
+    FeatureMatrix shuffled(train.rows(), train.dimension(), representation);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        std::copy(train.row(order[i]), train.row(order[i]) + train.dimension(), shuffled.mutableRow(i));
+        shuffled.setLabel(i, train.label(order[i]));
+    }
+    const std::string packed = (fs::temp_directory_path() / "bench_kmeans_stream.rfds").string();
+    if (!DescriptorStore::write(packed, shuffled)) {
+        std::cerr << "Erreur : Impossible d'écrire " << packed << std::endl;
+        return 1;
+    }
+
+    std::cout << std::endl << std::setw(18) << "Entraînement" << std::setw(14) << "Itérations"
+              << std::setw(16) << "Inertie" << "Durée (ms)" << std::endl;
+    KMeans batchModel(clusters, static_cast<int>(train.dimension()), 100, 1e-4);
+    auto start = std::chrono::steady_clock::now();
+    batchModel.fit(shuffled);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(18) << "fit" << std::setw(14) << batchModel.getIterations(representation)
+              << std::setw(16) << batchModel.getInertia(representation) << seconds * 1000.0 << std::endl;
+    for (std::size_t batchSize : {std::size_t(64), std::size_t(256), std::size_t(1024)}) {
+        if (batchSize < static_cast<std::size_t>(clusters)) continue;
+        KMeans streamModel(clusters, static_cast<int>(train.dimension()), 100, 1e-4);
+        start = std::chrono::steady_clock::now();
+        const bool streamed = streamModel.fitStream(packed, batchSize);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::setw(18) << ("fitStream " + std::to_string(batchSize))
+                  << std::setw(14) << streamModel.getIterations(representation)
+                  << std::setw(16) << streamModel.getInertia(representation) << seconds * 1000.0 << std::endl;
+        ok = ok && streamed;
+    }
+    fs::remove(packed);
+    return ok ? 0 : 1;
+}
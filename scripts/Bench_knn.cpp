@@ -0,0 +1,104 @@
+#include "classifier/KNNClassifier.h"
+#include "dataRepo/FeatureMatrix.h"
+#include "dataRepo/RepresentationTraits.h"
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Compare la recherche KNN exhaustive requête par requête (`findKNearestNeighbors`), par lot
+ * (`findKNearestNeighborsBatch`), avec le KD-tree et avec la force brute élaguée sur des données
+ * aléatoires, et vérifie que les voisins sont identiques. Une partie des lignes d'entraînement est
+ * dupliquée pour tester les ex aequo.
+ * Usage : bench_knn [lignes = 20000] [requêtes = 500] [k = 12] [distance = euclidean]
+ */
+
+FeatureMatrix randomMatrix(std::size_t rows, std::size_t dimension, RepresentationId id, std::mt19937& gen) {
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+    std::uniform_int_distribution<int> label(0, 17);
+    FeatureMatrix matrix(rows, dimension, id);
+    for (std::size_t i = 0; i < rows; ++i) {
+        double* target = matrix.mutableRow(i);
+        if (i % 10 == 9) {
+            std::copy(matrix.row(i - 1), matrix.row(i - 1) + dimension, target);
+        } else {
+            for (std::size_t j = 0; j < dimension; ++j) {
+                target[j] = value(gen);
+            }
+        }
+        matrix.setLabel(i, label(gen));
+    }
+    return matrix;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t rows = argc > 1 ? std::stoul(argv[1]) : 20000;
+    std::size_t numQueries = argc > 2 ? std::stoul(argv[2]) : 500;
+    int k = argc > 3 ? std::stoi(argv[3]) : 12;
+    std::string distance = argc > 4 ? argv[4] : "euclidean";
+    std::mt19937 gen(42);
+
+    KNNIndexOptions bruteForce;
+    bruteForce.backend = KNNIndexOptions::Backend::BruteForce;
+    KNNIndexOptions kdTree;
+    kdTree.backend = KNNIndexOptions::Backend::KDTree;
+    KNNIndexOptions pruned;
+    pruned.backend = KNNIndexOptions::Backend::PrunedScan;
+
+    std::cout << std::left << std::setw(10) << "Repr." << std::setw(6) << "Dim"
+              << std::setw(24) << "Par requête (ms)" << std::setw(18) << "Par lot (ms)"
+              << std::setw(18) << "KD-tree (ms)" << std::setw(18) << "Élaguée (ms)"
+              << "Gain lot / KD-tree / élaguée" << std::endl;
+
+    for (std::size_t r = 1; r < kRepresentationCount; ++r) {
+        const RepresentationTraits& traits = kRepresentationTraits[r];
+        FeatureMatrix train = randomMatrix(rows, traits.dimension, traits.id, gen);
+        FeatureMatrix queries = randomMatrix(numQueries, traits.dimension, traits.id, gen);
+        // Quelques requêtes identiques à des lignes d'entraînement (distance nulle).
+        for (std::size_t q = 0; q < numQueries; q += 7) {
+            std::copy(train.row(q), train.row(q) + traits.dimension, queries.mutableRow(q));
+        }
+        KNNClassifier knn(train, k, distance, bruteForce);
+        KNNClassifier knnTree(train, k, distance, kdTree);
+        KNNClassifier knnPruned(train, k, distance, pruned);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<double, int>>> single(numQueries);
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            single[q] = knn.findKNearestNeighbors(queries.toImage(q));
+        }
+        double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<double, int>>> batch = knn.findKNearestNeighborsBatch(queries);
+        double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<double, int>>> tree(numQueries);
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            tree[q] = knnTree.findKNearestNeighbors(queries.toImage(q));
+        }
+        double treeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<double, int>>> prunedScan(numQueries);
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            prunedScan[q] = knnPruned.findKNearestNeighbors(queries.toImage(q));
+        }
+        double prunedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::setw(10) << traits.name << std::setw(6) << traits.dimension
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(24) << singleSeconds * 1e3 << std::setw(18) << batchSeconds * 1e3
+                  << std::setw(18) << treeSeconds * 1e3 << std::setw(18) << prunedSeconds * 1e3
+                  << "x" << singleSeconds / batchSeconds << " / x" << singleSeconds / treeSeconds
+                  << " / x" << singleSeconds / prunedSeconds
+                  << (single == batch ? "" : "  (lot : voisins différents !)")
+                  << (single == tree ? "" : "  (KD-tree : voisins différents !)")
+                  << (single == prunedScan ? "" : "  (élaguée : voisins différents !)") << std::endl;
+    }
+    return 0;
+}
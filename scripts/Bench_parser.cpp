@@ -0,0 +1,80 @@
+#include "dataRepo/DescriptorParser.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Compare le débit (Mo/s) de la lecture `ifstream >> double` et de `DescriptorParser`
+ * sur tous les fichiers de descripteurs d'un répertoire.
+ * Usage : bench_parser [répertoire = data/=Signatures] [répétitions = 20]
+ */
+
+bool readWithStream(const std::string& path, std::vector<double>& out) {
+    out.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    double value;
+    while (file >> value) {
+        out.push_back(value);
+    }
+    return !file.bad();
+}
+
+int main(int argc, char* argv[]) {
+    std::string dirPath = argc > 1 ? argv[1] : "data/=Signatures";
+    int repetitions = argc > 2 ? std::stoi(argv[2]) : 20;
+
+    std::vector<std::string> files;
+    std::uintmax_t totalBytes = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(dirPath)) {
+        if (entry.is_regular_file() && DescriptorParser::expectedDimensionForPath(entry.path().string()) != 0) {
+            files.push_back(entry.path().string());
+            totalBytes += entry.file_size();
+        }
+    }
+    if (files.empty()) {
+        std::cerr << "Aucun fichier de descripteurs dans " << dirPath << std::endl;
+        return 1;
+    }
+
+    // Vérifie que les deux méthodes lisent exactement les mêmes valeurs.
+    std::vector<double> expected, parsed;
+    std::string errorMessage;
+    size_t mismatches = 0;
+    for (const auto& path : files) {
+        readWithStream(path, expected);
+        DescriptorParser::parseFile(path, parsed, DescriptorParser::expectedDimensionForPath(path), errorMessage);
+        if (expected != parsed) ++mismatches;
+    }
+
+    auto measure = [&](auto&& readOne) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetitions; ++r) {
+            for (const auto& path : files) {
+                readOne(path);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(totalBytes) * repetitions / (1024.0 * 1024.0) / elapsed.count();
+    };
+
+    std::vector<double> values;
+    double streamRate = measure([&](const std::string& path) { readWithStream(path, values); });
+    double parserRate = measure([&](const std::string& path) {
+        DescriptorParser::parseFile(path, values, DescriptorParser::expectedDimensionForPath(path), errorMessage);
+    });
+
+    std::cout << "Fichiers : " << files.size() << " (" << totalBytes << " octets), répétitions : " << repetitions << "\n"
+              << "Fichiers différents entre les deux méthodes : " << mismatches << "\n"
+              << std::fixed << std::setprecision(1)
+              << "ifstream >> double : " << streamRate << " Mo/s\n"
+              << "DescriptorParser   : " << parserRate << " Mo/s\n"
+              << "Gain               : x" << std::setprecision(2) << parserRate / streamRate << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+#include "classifier/KNNClassifier.h"
+#include "classifier/QueryContext.h"
+#include "dataRepo/FeatureMatrix.h"
+#include "dataRepo/RepresentationTraits.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Compte les allocations du chemin de requête de `KNNClassifier` : après un premier passage qui rode
+ * les tampons, chaque structure de recherche prédit toutes les requêtes avec un `QueryContext`
+ * (puis avec le contexte par thread de `predictLabelWithConfidence(Image)`) pendant que les
+ * `operator new` du programme sont comptés. Vérifie aussi que les prédictions sont celles de
+ * `predictBatch`.
+ * Usage : bench_query [lignes = 20000] [requêtes = 500] [k = 12] [distance = euclidean]
+ */
+
+namespace {
+    std::atomic<std::size_t> allocations(0);
+}
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+FeatureMatrix randomMatrix(std::size_t rows, std::size_t dimension, RepresentationId id, std::mt19937& gen) {
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+    std::uniform_int_distribution<int> label(1, 18);
+    FeatureMatrix matrix(rows, dimension, id);
+    for (std::size_t i = 0; i < rows; ++i) {
+        double* target = matrix.mutableRow(i);
+        for (std::size_t j = 0; j < dimension; ++j) {
+            target[j] = value(gen);
+        }
+        matrix.setLabel(i, label(gen));
+    }
+    return matrix;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t rows = argc > 1 ? std::stoul(argv[1]) : 20000;
+    std::size_t numQueries = argc > 2 ? std::stoul(argv[2]) : 500;
+    int k = argc > 3 ? std::stoi(argv[3]) : 12;
+    std::string distance = argc > 4 ? argv[4] : "euclidean";
+    std::mt19937 gen(42);
+
+    const RepresentationTraits& traits = representationTraits(RepresentationId::GFD);
+    FeatureMatrix train = randomMatrix(rows, traits.dimension, traits.id, gen);
+    FeatureMatrix queries = randomMatrix(numQueries, traits.dimension, traits.id, gen);
+    std::vector<Image> images;
+    for (std::size_t q = 0; q < numQueries; ++q) {
+        images.push_back(queries.toImage(q));
+    }
+
+    const std::pair<KNNIndexOptions::Backend, const char*> backends[] = {
+        {KNNIndexOptions::Backend::BruteForce, "BruteForce"},
+        {KNNIndexOptions::Backend::KDTree, "KDTree"},
+        {KNNIndexOptions::Backend::HNSW, "HNSW"},
+        {KNNIndexOptions::Backend::PQ, "PQ"},
+        {KNNIndexOptions::Backend::IVF, "IVF"},
+        {KNNIndexOptions::Backend::PrunedScan, "PrunedScan"},
+    };
+
+    std::cout << rows << " lignes, dimension " << traits.dimension << ", " << numQueries << " requêtes, K = " << k
+              << ", " << distance << std::endl;
+    std::cout << std::left << std::setw(14) << "Index" << std::setw(22) << "Par requête (µs)"
+              << std::setw(22) << "Allocations contexte" << std::setw(24) << "Allocations par thread"
+              << "Prédictions" << std::endl;
+
+    bool ok = true;
+    for (const auto& backend : backends) {
+        KNNIndexOptions options;
+        options.backend = backend.first;
+        KNNClassifier knn(train, k, distance, options);
+        std::vector<std::pair<int, double>> expected = knn.predictBatch(queries);
+        std::vector<std::pair<int, double>> predictions(numQueries);
+        QueryContext context;
+
+        // Premier passage : les tampons du contexte et des index atteignent leur taille définitive.
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            knn.predictLabelWithConfidence(queries.row(q), context);
+            knn.predictLabelWithConfidence(images[q]);
+        }
+
+        std::size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            predictions[q] = knn.predictLabelWithConfidence(queries.row(q), context);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::size_t contextAllocations = allocations.load() - before;
+
+        bool same = predictions == expected;
+        before = allocations.load();
+        for (std::size_t q = 0; q < numQueries; ++q) {
+            predictions[q] = knn.predictLabelWithConfidence(images[q]);
+        }
+        std::size_t threadAllocations = allocations.load() - before;
+        // Les index approchés donnent les mêmes voisins par lot et requête par requête.
+        same = same && predictions == expected;
+
+        std::cout << std::setw(14) << backend.second << std::setw(22) << seconds * 1e6 / numQueries
+                  << std::setw(22) << contextAllocations << std::setw(24) << threadAllocations
+                  << (same ? "identiques" : "DIFFÉRENTES") << std::endl;
+        ok = ok && same && contextAllocations == 0 && threadAllocations == 0;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,339 @@
+#include "classifier/KMeans.h"
+#include "classifier/KNNClassifier.h"
+#include "classifier/QueryContext.h"
+#include "dataRepo/DescriptorParser.h"
+#include "dataRepo/DescriptorStore.h"
+#include "dataRepo/FeatureMatrix.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Vérifie que les chemins optimisés donnent les mêmes résultats que leur référence, sur des
+ * données synthétiques (graine fixe, sans dépendre de data/) :
+ *   - `DescriptorParser` accepte et rejette les mêmes entrées que `istream >> double` ;
+ *   - un `DescriptorStore` relu redonne exactement la matrice écrite (float64), ou sa conversion (float32) ;
+ *   - les index exacts (KD-tree, PrunedScan, IVF avec toutes les listes parcourues) et `predictBatch`
+ *     trouvent les mêmes voisins que la force brute ;
+ *   - les assignations Hamerly et Elkan de `KMeans` donnent les mêmes centroids que Lloyd, les
+ *     entraînements de `fit` (nInit > 1) ne dépendent pas du nombre de threads, et l'inertie de
+ *     `fitStream` est celle de ses centroids finaux.
+ * Usage : check_parity
+ * Sortie : 0 si aucune divergence, 1 sinon (les premières divergences sont affichées).
+ */
+
+struct CheckReport {
+    std::string name;
+    std::size_t cases = 0;
+    std::size_t failures = 0;
+
+    void fail(const std::string& message) {
+        if (++failures <= 10) {
+            std::cerr << "[" << name << "] " << message << std::endl;
+        }
+    }
+};
+
+// Comparaison bit à bit : distingue 0 et -0, et toute différence d'arrondi.
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+FeatureMatrix randomMatrix(std::size_t rows, RepresentationId representation, std::mt19937& generator) {
+    const std::size_t dimension = representationDimension(representation);
+    FeatureMatrix matrix(rows, dimension, representation);
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+    std::uniform_int_distribution<int> label(1, 18);
+    for (std::size_t i = 0; i < rows; ++i) {
+        double* target = matrix.mutableRow(i);
+        for (std::size_t j = 0; j < dimension; ++j) {
+            target[j] = value(generator);
+        }
+        matrix.setLabel(i, label(generator));
+        matrix.setPath(i, "s" + std::to_string(label(generator)) + "n" + std::to_string(i) + ".txt");
+    }
+    return matrix;
+}
+
+std::vector<double> readWithStream(const std::string& text) {
+    std::vector<double> out;
+    std::istringstream stream(text);
+    double value;
+    while (stream >> value) {
+        out.push_back(value);
+    }
+    return out;
+}
+
+CheckReport checkParser() {
+    CheckReport report{"parser"};
+    std::vector<std::string> cases = {
+        "", "   \n\t", "1 2 3", "1.5e3 -2.25E-2 +7", "0.1\n0.2\r\n0.3", ".5 -.5 +.5", "5. -5.",
+        "inf", "-inf", "+inf", "nan", "NaN", "infinity", "1 inf 2", "1 nan 2",
+        "1e", "1e+", "1e-", "1E 2", "1ex", "1e5x", "1e5e", "1.5abc 2", "1.5.3", "1,5", "abc", "--1", "+-1", "-+1",
+        "+", "-", ".", "-.", "0x1A", "0x", "1e400", "-1e400", "1e-400", "-1e-400", "4.9e-324",
+        "2.2250738585072011e-308", "1e-310", "0 -0 +0", "00012 -000.5", "1.7976931348623157e308",
+        "1.7976931348623159e308", "123456789012345678901234567890", "0.30000000000000004441", "1\v2\f3",
+    };
+
+    // Textes aléatoires construits à partir de fragments proches du format des fichiers.
+    const char* fragments[] = {"0", "1", "9", ".", "-", "+", "e", "E", " ", "\n", "i", "n", "f", "a", "x", "400"};
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> pick(0, sizeof(fragments) / sizeof(fragments[0]) - 1);
+    std::uniform_int_distribution<int> length(1, 12);
+    for (int c = 0; c < 20000; ++c) {
+        std::string text;
+        for (int l = length(generator); l > 0; --l) {
+            text += fragments[pick(generator)];
+        }
+        cases.push_back(text);
+    }
+
+    for (const auto& text : cases) {
+        std::vector<double> expected = readWithStream(text);
+        std::vector<double> parsed;
+        DescriptorParser::parseBuffer(text.data(), text.data() + text.size(), parsed);
+        ++report.cases;
+        bool same = expected.size() == parsed.size();
+        for (std::size_t i = 0; same && i < expected.size(); ++i) {
+            same = sameBits(expected[i], parsed[i]);
+        }
+        if (!same) {
+            report.fail("\"" + text + "\" : " + std::to_string(expected.size()) + " valeur(s) attendue(s), "
+                        + std::to_string(parsed.size()) + " lue(s)");
+        }
+    }
+    return report;
+}
+
+CheckReport checkStore() {
+    CheckReport report{"store"};
+    std::mt19937 generator(7);
+    const std::string path = (fs::temp_directory_path() / "check_parity.rfds").string();
+
+    for (RepresentationId representation : {RepresentationId::GFD, RepresentationId::ART, RepresentationId::Yang,
+                                            RepresentationId::Zernike7}) {
+        for (auto type : {DescriptorStore::ElementType::Float64, DescriptorStore::ElementType::Float32}) {
+            ++report.cases;
+            FeatureMatrix written = randomMatrix(37, representation, generator);
+            DescriptorStore store;
+            if (!DescriptorStore::write(path, written, type) || !store.open(path)) {
+                report.fail("écriture ou relecture impossible pour " + representationName(representation));
+                continue;
+            }
+            FeatureMatrix read = store.view();
+            if (read.rows() != written.rows() || read.dimension() != written.dimension()
+                || read.getRepresentationId() != representation) {
+                report.fail("taille ou représentation différente pour " + representationName(representation));
+                continue;
+            }
+            for (std::size_t i = 0; i < written.rows(); ++i) {
+                bool same = read.label(i) == written.label(i) && read.path(i) == written.path(i)
+                            && store.path(i) == written.path(i);
+                for (std::size_t j = 0; same && j < written.dimension(); ++j) {
+                    const double expected = (type == DescriptorStore::ElementType::Float32)
+                                                ? static_cast<double>(static_cast<float>(written.at(i, j)))
+                                                : written.at(i, j);
+                    same = sameBits(read.at(i, j), expected);
+                }
+                if (!same) {
+                    report.fail("ligne " + std::to_string(i) + " différente pour " + representationName(representation));
+                }
+            }
+        }
+    }
+    std::remove(path.c_str());
+    return report;
+}
+
+// Les voisins trouvés doivent avoir les mêmes distances (à l'arrondi près : l'ordre des sommes
+// diffère d'un noyau à l'autre) et les mêmes labels.
+bool sameNeighbors(const std::vector<std::pair<double, int>>& expected, const std::vector<std::pair<double, int>>& found) {
+    if (expected.size() != found.size()) return false;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        if (std::abs(expected[i].first - found[i].first) > 1e-9 * std::max(1.0, expected[i].first)
+            || expected[i].second != found[i].second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+CheckReport checkNeighbors() {
+    CheckReport report{"knn"};
+    std::mt19937 generator(11);
+
+    using Backend = KNNIndexOptions::Backend;
+    for (RepresentationId representation : {RepresentationId::Zernike7, RepresentationId::Yang, RepresentationId::GFD}) {
+        FeatureMatrix train = randomMatrix(500, representation, generator);
+        FeatureMatrix queries = randomMatrix(60, representation, generator);
+        for (const std::string distance : {"euclidean", "manhattan"}) {
+            for (int k : {1, 12}) {
+                KNNIndexOptions bruteOptions;
+                bruteOptions.backend = Backend::BruteForce;
+                KNNClassifier brute(train, k, distance, bruteOptions);
+
+                for (Backend backend : {Backend::BruteForce, Backend::KDTree, Backend::PrunedScan, Backend::IVF}) {
+                    KNNIndexOptions options;
+                    options.backend = backend;
+                    options.kdTreeLeafSize = 8;
+                    options.ivf.nprobe = train.rows();
+                    KNNClassifier classifier(train, k, distance, options);
+                    const std::string name = std::string(classifier.indexName()) + " " + distance + " k=" + std::to_string(k)
+                                             + " " + representationName(representation);
+
+                    auto batch = classifier.findKNearestNeighborsBatch(queries);
+                    QueryContext expectedContext;
+                    QueryContext context;
+                    for (std::size_t q = 0; q < queries.rows(); ++q) {
+                        ++report.cases;
+                        const auto& expected = brute.findKNearestNeighbors(queries.row(q), expectedContext);
+                        const auto& found = classifier.findKNearestNeighbors(queries.row(q), context);
+                        if (!sameNeighbors(expected, found) || !sameNeighbors(expected, batch[q])) {
+                            report.fail(name + " : voisins différents pour la requête " + std::to_string(q));
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return report;
+}
+
+CheckReport checkKMeans() {
+    CheckReport report{"kmeans"};
+    std::mt19937 generator(23);
+
+    using Algorithm = KMeansOptions::Algorithm;
+    for (RepresentationId representation : {RepresentationId::Zernike7, RepresentationId::GFD}) {
+        FeatureMatrix train = randomMatrix(400, representation, generator);
+        const int dimension = static_cast<int>(train.dimension());
+        for (int clusters : {3, 10, 30}) {
+            KMeansOptions lloydOptions;
+            lloydOptions.algorithm = Algorithm::Lloyd;
+            KMeans lloyd(clusters, dimension, 100, 1e-4, lloydOptions);
+            lloyd.fit(train);
+            const FeatureMatrix& expected = lloyd.getCentroids(representation);
+
+            for (Algorithm algorithm : {Algorithm::Hamerly, Algorithm::Elkan}) {
+                ++report.cases;
+                KMeansOptions options;
+                options.algorithm = algorithm;
+                KMeans kmeans(clusters, dimension, 100, 1e-4, options);
+                kmeans.fit(train);
+                const FeatureMatrix& found = kmeans.getCentroids(representation);
+
+                bool same = found.rows() == expected.rows()
+                            && kmeans.getIterations(representation) == lloyd.getIterations(representation);
+                for (std::size_t c = 0; same && c < expected.rows(); ++c) {
+                    for (std::size_t j = 0; same && j < expected.dimension(); ++j) {
+                        same = sameBits(found.at(c, j), expected.at(c, j));
+                    }
+                }
+                if (!same) {
+                    report.fail(std::string(algorithm == Algorithm::Hamerly ? "Hamerly" : "Elkan") + " k="
+                                + std::to_string(clusters) + " " + representationName(representation)
+                                + " : centroids ou itérations différents de Lloyd");
+                }
+            }
+        }
+    }
+
+    // nInit > 1 : les entraînements (centroids, inertie, itérations de chacun, entraînement gardé)
+    // ne dépendent pas du nombre de threads, en deçà comme au-delà d'un bloc de lignes.
+    for (std::size_t rows : {400, 1500}) {
+        FeatureMatrix train = randomMatrix(rows, RepresentationId::Zernike7, generator);
+        const int dimension = static_cast<int>(train.dimension());
+        KMeansOptions sequentialOptions;
+        sequentialOptions.numThreads = 1;
+        sequentialOptions.nInit = 4;
+        KMeans reference(10, dimension, 100, 1e-4, sequentialOptions);
+        reference.fit(train);
+        const FeatureMatrix& expected = reference.getCentroids(RepresentationId::Zernike7);
+        const std::vector<KMeansRestart>& expectedRestarts = reference.getRestarts(RepresentationId::Zernike7);
+
+        for (std::size_t threads : {2, 4, 0}) {
+            ++report.cases;
+            KMeansOptions options = sequentialOptions;
+            options.numThreads = threads;
+            KMeans kmeans(10, dimension, 100, 1e-4, options);
+            kmeans.fit(train);
+            const FeatureMatrix& found = kmeans.getCentroids(RepresentationId::Zernike7);
+            const std::vector<KMeansRestart>& restarts = kmeans.getRestarts(RepresentationId::Zernike7);
+
+            bool same = found.rows() == expected.rows() && restarts.size() == expectedRestarts.size()
+                        && kmeans.getBestRestart(RepresentationId::Zernike7)
+                               == reference.getBestRestart(RepresentationId::Zernike7)
+                        && sameBits(kmeans.getInertia(RepresentationId::Zernike7),
+                                    reference.getInertia(RepresentationId::Zernike7));
+            for (std::size_t r = 0; same && r < restarts.size(); ++r) {
+                same = restarts[r].seed == expectedRestarts[r].seed && restarts[r].iterations == expectedRestarts[r].iterations
+                       && sameBits(restarts[r].inertia, expectedRestarts[r].inertia);
+            }
+            for (std::size_t c = 0; same && c < expected.rows(); ++c) {
+                for (std::size_t j = 0; same && j < expected.dimension(); ++j) {
+                    same = sameBits(found.at(c, j), expected.at(c, j));
+                }
+            }
+            if (!same) {
+                report.fail("nInit=4 " + std::to_string(rows) + " lignes, numThreads=" + std::to_string(threads)
+                            + " : entraînements différents de numThreads=1");
+            }
+        }
+    }
+
+    // fitStream : l'inertie rapportée est celle des centroids finaux sur toutes les lignes.
+    const std::string path = (fs::temp_directory_path() / "check_parity_stream.rfds").string();
+    FeatureMatrix train = randomMatrix(700, RepresentationId::Zernike7, generator);
+    if (DescriptorStore::write(path, train)) {
+        for (std::size_t batchSize : {64, 256, 1000}) {
+            ++report.cases;
+            KMeans kmeans(10, static_cast<int>(train.dimension()));
+            kmeans.fitStream(path, batchSize);
+            const FeatureMatrix& centroids = kmeans.getCentroids(RepresentationId::Zernike7);
+            double expected = 0.0;
+            for (std::size_t i = 0; i < train.rows(); ++i) {
+                double closest = std::numeric_limits<double>::max();
+                for (std::size_t c = 0; c < centroids.rows(); ++c) {
+                    double sum = 0.0;
+                    for (std::size_t j = 0; j < train.dimension(); ++j) {
+                        const double diff = train.at(i, j) - centroids.at(c, j);
+                        sum += diff * diff;
+                    }
+                    closest = std::min(closest, sum);
+                }
+                expected += closest;
+            }
+            const double inertia = kmeans.getInertia(RepresentationId::Zernike7);
+            if (centroids.empty() || std::abs(inertia - expected) > 1e-9 * expected) {
+                report.fail("fitStream lots de " + std::to_string(batchSize) + " : inertie " + std::to_string(inertia)
+                            + " au lieu de " + std::to_string(expected));
+            }
+        }
+    } else {
+        report.fail("écriture impossible de " + path);
+    }
+    std::remove(path.c_str());
+    return report;
+}
+
+int main() {
+    std::vector<CheckReport> reports = {checkParser(), checkStore(), checkNeighbors(), checkKMeans()};
+
+    std::size_t failures = 0;
+    for (const auto& report : reports) {
+        std::cout << report.name << " : " << report.cases << " cas, " << report.failures << " divergence(s)" << std::endl;
+        failures += report.failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include "dataRepo/DataCollection.h"
+#include "dataRepo/DescriptorStore.h"
+#include <iostream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * Regroupe les descripteurs texte d'un répertoire dans un fichier binaire `DescriptorStore`.
+ * Entrée :
+ *   - sourceDir (std::string) : Répertoire contenant les fichiers .gfd/.art/.yng/.txt.
+ *   - outputPath (std::string) : Fichier binaire à créer.
+ *   - type (DescriptorStore::ElementType) : Précision des descripteurs stockés.
+ * Sortie (bool) : true si le fichier est écrit.
+ */
+bool packDirectory(const std::string& sourceDir, const std::string& outputPath, DescriptorStore::ElementType type) {
+    DataCollection collection;
+    collection.loadDatasetFromDirectory(sourceDir);
+
+    FeatureMatrix matrix = collection.getFeatureMatrix();
+    if (matrix.empty()) {
+        std::cerr << "Erreur : Aucun descripteur trouvé dans " << sourceDir << std::endl;
+        return false;
+    }
+
+    if (!DescriptorStore::write(outputPath, matrix, type)) {
+        return false;
+    }
+    std::cout << matrix.rows() << " descripteurs " << matrix.getRepresentationType()
+              << " écrits dans : " << outputPath << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    DescriptorStore::ElementType type = DescriptorStore::ElementType::Float64;
+    for (auto it = args.begin(); it != args.end();) {
+        if (*it == "--float32") {
+            type = DescriptorStore::ElementType::Float32;
+            it = args.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (args.size() == 2 && args[0] == "--all") {
+        // Pack train2/test2 de chaque représentation : <rep>/train2 -> <rep>/train2.rfds
+        bool ok = true;
+        for (const auto& entry : fs::directory_iterator(args[1])) {
+            if (!entry.is_directory()) continue;
+            for (const std::string split : {"train2", "test2"}) {
+                fs::path sourceDir = entry.path() / split;
+                if (fs::exists(sourceDir)) {
+                    ok = packDirectory(sourceDir.string(), sourceDir.string() + ".rfds", type) && ok;
+                }
+            }
+        }
+        return ok ? 0 : 1;
+    }
+
+    if (args.size() != 2) {
+        std::cerr << "Usage : pack_signatures [--float32] <répertoire> <fichier.rfds>\n"
+                  << "        pack_signatures [--float32] --all <data/=Signatures>" << std::endl;
+        return 1;
+    }
+    return packDirectory(args[0], args[1], type) ? 0 : 1;
+}
@@ -0,0 +1,483 @@
+#include "classifier/DistanceKernels.h"
+#include "dataRepo/RepresentationTraits.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+// Interdit la fusion multiplication + addition (FMA, disponible avec AVX-512) : toutes les
+// versions doivent arrondir chaque terme de la même façon pour donner le même résultat.
+#pragma GCC optimize("fp-contract=off")
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DISTANCE_KERNELS_X86 1
+#endif
+
+namespace {
+    typedef double Double2 __attribute__((vector_size(16)));
+    typedef double Double4 __attribute__((vector_size(32)));
+    typedef double Double8 __attribute__((vector_size(64)));
+    typedef float Float4 __attribute__((vector_size(16)));
+    typedef float Float8 __attribute__((vector_size(32)));
+    typedef float Float16 __attribute__((vector_size(64)));
+
+    struct SquaredDifference {
+        template <typename V>
+        __attribute__((always_inline)) static inline void accumulate(V& acc, const V& x, const V& y) {
+            V d = x - y;
+            acc += d * d;
+        }
+    };
+
+    struct AbsoluteDifference {
+        __attribute__((always_inline)) static inline void accumulate(double& acc, double x, double y) {
+            acc += std::fabs(x - y);
+        }
+
+        __attribute__((always_inline)) static inline void accumulate(float& acc, float x, float y) {
+            acc += std::fabs(x - y);
+        }
+
+        // Valeur absolue vectorielle : on efface le bit de signe de chaque élément.
+        template <typename V>
+        __attribute__((always_inline)) static inline void accumulate(V& acc, const V& x, const V& y) {
+            using Bits = decltype(x < y);
+            V d = x - y;
+            acc += (V)((Bits)d & ~(Bits)(-V{}));
+        }
+    };
+
+    /**
+     * Corps commun à tous les noyaux.
+     * T : type des descripteurs ; V : type d'un registre (T lui-même pour la version scalaire) ;
+     * Dimension : taille fixée à la compilation, ou 0 pour lire `size`.
+     */
+    template <typename T, typename V, typename Op, std::size_t Dimension>
+    __attribute__((always_inline)) inline double reduce(const T* a, const T* b, std::size_t size) {
+        constexpr std::size_t kLanes = DistanceKernels::kAccumulatorBytes / sizeof(T);
+        constexpr std::size_t kWidth = sizeof(V) / sizeof(T);
+        constexpr std::size_t kVectors = kLanes / kWidth;
+
+        const std::size_t n = Dimension != 0 ? Dimension : size;
+        const std::size_t blockEnd = n - n % kLanes;
+
+        V acc[kVectors] = {};
+        std::size_t i = 0;
+        for (; i < blockEnd; i += kLanes) {
+#pragma GCC unroll 32
+            for (std::size_t j = 0; j < kVectors; ++j) {
+                V x, y;
+                std::memcpy(&x, a + i + j * kWidth, sizeof(V));
+                std::memcpy(&y, b + i + j * kWidth, sizeof(V));
+                Op::accumulate(acc[j], x, y);
+            }
+        }
+
+        // Reste : registres complets d'abord, puis élément par élément, sur les mêmes voies.
+        std::size_t filled = 0;
+#pragma GCC unroll 32
+        for (std::size_t j = 0; j < kVectors; ++j) {
+            if (i + (j + 1) * kWidth <= n) {
+                V x, y;
+                std::memcpy(&x, a + i + j * kWidth, sizeof(V));
+                std::memcpy(&y, b + i + j * kWidth, sizeof(V));
+                Op::accumulate(acc[j], x, y);
+                filled = (j + 1) * kWidth;
+            }
+        }
+
+        T lanes[kLanes];
+        std::memcpy(lanes, acc, sizeof(lanes));
+#pragma GCC unroll 32
+        for (std::size_t k = 0; k < kWidth - 1; ++k) {
+            if (i + filled + k < n) {
+                Op::accumulate(lanes[filled + k], a[i + filled + k], b[i + filled + k]);
+            }
+        }
+
+        // Réduction par moitiés : lanes[k] += lanes[k + moitié].
+#pragma GCC unroll 32
+        for (std::size_t half = kLanes / 2; half > 0; half /= 2) {
+#pragma GCC unroll 32
+            for (std::size_t k = 0; k < half; ++k) {
+                lanes[k] += lanes[k + half];
+            }
+        }
+        return lanes[0];
+    }
+
+    template <typename Op, std::size_t Dimension>
+    double scalarDouble(const double* a, const double* b, std::size_t size) {
+        return reduce<double, double, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    double scalarFloat(const float* a, const float* b, std::size_t size) {
+        return reduce<float, float, Op, Dimension>(a, b, size);
+    }
+
+#ifdef DISTANCE_KERNELS_X86
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("sse2"))) double sse2Double(const double* a, const double* b, std::size_t size) {
+        return reduce<double, Double2, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("sse2"))) double sse2Float(const float* a, const float* b, std::size_t size) {
+        return reduce<float, Float4, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("avx2"))) double avx2Double(const double* a, const double* b, std::size_t size) {
+        return reduce<double, Double4, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("avx2"))) double avx2Float(const float* a, const float* b, std::size_t size) {
+        return reduce<float, Float8, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("avx512f"))) double avx512Double(const double* a, const double* b, std::size_t size) {
+        return reduce<double, Double8, Op, Dimension>(a, b, size);
+    }
+
+    template <typename Op, std::size_t Dimension>
+    __attribute__((target("avx512f"))) double avx512Float(const float* a, const float* b, std::size_t size) {
+        return reduce<float, Float16, Op, Dimension>(a, b, size);
+    }
+#endif
+
+    /**
+     * Bloc de `Rows` requêtes contre un panneau : Rows x (kPanelWidth / largeur de V) accumulateurs.
+     */
+    template <typename V, std::size_t Rows>
+    __attribute__((always_inline)) inline void dotPanelBlock(const double* queries, std::size_t queryStride,
+                                                             const double* panel, std::size_t dimension,
+                                                             double* out, std::size_t outStride) {
+        constexpr std::size_t kWidth = sizeof(V) / sizeof(double);
+        constexpr std::size_t kColumns = DistanceKernels::kPanelWidth / kWidth;
+
+        V acc[Rows][kColumns] = {};
+        for (std::size_t d = 0; d < dimension; ++d) {
+            V column[kColumns];
+#pragma GCC unroll 16
+            for (std::size_t c = 0; c < kColumns; ++c) {
+                std::memcpy(&column[c], panel + d * DistanceKernels::kPanelWidth + c * kWidth, sizeof(V));
+            }
+#pragma GCC unroll 8
+            for (std::size_t r = 0; r < Rows; ++r) {
+                V value = V{} + queries[r * queryStride + d];
+#pragma GCC unroll 16
+                for (std::size_t c = 0; c < kColumns; ++c) {
+                    acc[r][c] += value * column[c];
+                }
+            }
+        }
+#pragma GCC unroll 8
+        for (std::size_t r = 0; r < Rows; ++r) {
+#pragma GCC unroll 16
+            for (std::size_t c = 0; c < kColumns; ++c) {
+                std::memcpy(out + r * outStride + c * kWidth, &acc[r][c], sizeof(V));
+            }
+        }
+    }
+
+    template <typename V, std::size_t Rows>
+    __attribute__((always_inline)) inline void dotPanel(const double* queries, std::size_t queryStride, std::size_t rows,
+                                                        const double* panel, std::size_t dimension,
+                                                        double* out, std::size_t outStride) {
+        std::size_t r = 0;
+        for (; r + Rows <= rows; r += Rows) {
+            dotPanelBlock<V, Rows>(queries + r * queryStride, queryStride, panel, dimension, out + r * outStride, outStride);
+        }
+        for (; r < rows; ++r) {
+            dotPanelBlock<V, 1>(queries + r * queryStride, queryStride, panel, dimension, out + r * outStride, outStride);
+        }
+    }
+
+    void scalarDotPanel(const double* queries, std::size_t queryStride, std::size_t rows,
+                        const double* panel, std::size_t dimension, double* out, std::size_t outStride) {
+        dotPanel<double, 1>(queries, queryStride, rows, panel, dimension, out, outStride);
+    }
+
+#ifdef DISTANCE_KERNELS_X86
+    // Nombre de requêtes par bloc choisi pour remplir les registres sans débordement :
+    // 8 accumulateurs en SSE2 (16 registres), 12 en AVX2 (16 registres), 16 en AVX-512 (32 registres).
+    __attribute__((target("sse2"))) void sse2DotPanel(const double* queries, std::size_t queryStride, std::size_t rows,
+                                                      const double* panel, std::size_t dimension, double* out, std::size_t outStride) {
+        dotPanel<Double2, 1>(queries, queryStride, rows, panel, dimension, out, outStride);
+    }
+
+    __attribute__((target("avx2"))) void avx2DotPanel(const double* queries, std::size_t queryStride, std::size_t rows,
+                                                      const double* panel, std::size_t dimension, double* out, std::size_t outStride) {
+        dotPanel<Double4, 3>(queries, queryStride, rows, panel, dimension, out, outStride);
+    }
+
+    __attribute__((target("avx512f"))) void avx512DotPanel(const double* queries, std::size_t queryStride, std::size_t rows,
+                                                           const double* panel, std::size_t dimension, double* out, std::size_t outStride) {
+        dotPanel<Double8, 8>(queries, queryStride, rows, panel, dimension, out, outStride);
+    }
+#endif
+
+    /**
+     * Vrai si toutes les sommes d'un panneau dépassent `bound`. Le test porte sur le bit de signe de
+     * bound - somme (négatif si et seulement si la somme dépasse) : pas de comparaison vectorielle,
+     * que GCC ne sait pas traduire en masques AVX-512 sans intrinsics.
+     */
+    template <typename V, std::size_t Columns>
+    __attribute__((always_inline)) inline bool allAbove(const V* acc, double bound) {
+        if constexpr (std::is_same<V, double>::value) {
+            for (std::size_t c = 0; c < Columns; ++c) {
+                if (!(acc[c] > bound)) return false;
+            }
+            return true;
+        } else {
+            using Bits = decltype(acc[0] < acc[0]);
+            constexpr std::size_t kWidth = sizeof(V) / sizeof(double);
+            const V limit = V{} + bound;
+            Bits signs = (Bits)(limit - acc[0]);
+#pragma GCC unroll 16
+            for (std::size_t c = 1; c < Columns; ++c) {
+                signs &= (Bits)(limit - acc[c]);
+            }
+            long long lanes[kWidth];
+            std::memcpy(lanes, &signs, sizeof(lanes));
+            long long all = -1;
+#pragma GCC unroll 8
+            for (std::size_t k = 0; k < kWidth; ++k) {
+                all &= lanes[k];
+            }
+            return all < 0;
+        }
+    }
+
+    /**
+     * Une requête contre un panneau : kPanelWidth / largeur de V accumulateurs, un terme par
+     * dimension et par ligne, abandon quand toutes les sommes dépassent `bound`.
+     */
+    template <typename V, typename Op>
+    __attribute__((always_inline)) inline void boundedPanel(const double* query, const double* panel, std::size_t dimension,
+                                                            double bound, double* out) {
+        constexpr std::size_t kWidth = sizeof(V) / sizeof(double);
+        constexpr std::size_t kColumns = DistanceKernels::kPanelWidth / kWidth;
+
+        V acc[kColumns] = {};
+        for (std::size_t d = 0; d < dimension; ++d) {
+            V value = V{} + query[d];
+#pragma GCC unroll 16
+            for (std::size_t c = 0; c < kColumns; ++c) {
+                V column;
+                std::memcpy(&column, panel + d * DistanceKernels::kPanelWidth + c * kWidth, sizeof(V));
+                Op::accumulate(acc[c], value, column);
+            }
+            if ((d + 1) % DistanceKernels::kPanelCheckInterval == 0 && allAbove<V, kColumns>(acc, bound)) {
+                break;
+            }
+        }
+#pragma GCC unroll 16
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            std::memcpy(out + c * kWidth, &acc[c], sizeof(V));
+        }
+    }
+
+    template <typename Op>
+    void scalarBoundedPanel(const double* query, const double* panel, std::size_t dimension, double bound, double* out) {
+        boundedPanel<double, Op>(query, panel, dimension, bound, out);
+    }
+
+#ifdef DISTANCE_KERNELS_X86
+    template <typename Op>
+    __attribute__((target("sse2"))) void sse2BoundedPanel(const double* query, const double* panel, std::size_t dimension,
+                                                          double bound, double* out) {
+        boundedPanel<Double2, Op>(query, panel, dimension, bound, out);
+    }
+
+    template <typename Op>
+    __attribute__((target("avx2"))) void avx2BoundedPanel(const double* query, const double* panel, std::size_t dimension,
+                                                          double bound, double* out) {
+        boundedPanel<Double4, Op>(query, panel, dimension, bound, out);
+    }
+
+    template <typename Op>
+    __attribute__((target("avx512f"))) void avx512BoundedPanel(const double* query, const double* panel, std::size_t dimension,
+                                                               double bound, double* out) {
+        boundedPanel<Double8, Op>(query, panel, dimension, bound, out);
+    }
+#endif
+
+    template <typename Op>
+    DistanceKernels::BoundedPanelKernel selectBoundedPanel(DistanceKernels::InstructionSet isa) {
+        if (!DistanceKernels::isSupported(isa)) {
+            isa = DistanceKernels::activeInstructionSet();
+        }
+        switch (isa) {
+#ifdef DISTANCE_KERNELS_X86
+            case DistanceKernels::InstructionSet::AVX512: return &avx512BoundedPanel<Op>;
+            case DistanceKernels::InstructionSet::AVX2:   return &avx2BoundedPanel<Op>;
+            case DistanceKernels::InstructionSet::SSE2:   return &sse2BoundedPanel<Op>;
+#endif
+            default:                                      return &scalarBoundedPanel<Op>;
+        }
+    }
+
+    template <typename T>
+    using KernelOf = double (*)(const T*, const T*, std::size_t);
+
+    template <typename Op, typename T, std::size_t Dimension>
+    KernelOf<T> select(DistanceKernels::InstructionSet isa) {
+        constexpr bool isDouble = std::is_same<T, double>::value;
+        switch (isa) {
+#ifdef DISTANCE_KERNELS_X86
+            case DistanceKernels::InstructionSet::AVX512:
+                if constexpr (isDouble) return &avx512Double<Op, Dimension>; else return &avx512Float<Op, Dimension>;
+            case DistanceKernels::InstructionSet::AVX2:
+                if constexpr (isDouble) return &avx2Double<Op, Dimension>; else return &avx2Float<Op, Dimension>;
+            case DistanceKernels::InstructionSet::SSE2:
+                if constexpr (isDouble) return &sse2Double<Op, Dimension>; else return &sse2Float<Op, Dimension>;
+#endif
+            default:
+                if constexpr (isDouble) return &scalarDouble<Op, Dimension>; else return &scalarFloat<Op, Dimension>;
+        }
+    }
+
+    template <typename Op, typename T>
+    KernelOf<T> dispatch(std::size_t dimension, DistanceKernels::InstructionSet isa) {
+        if (!DistanceKernels::isSupported(isa)) {
+            isa = DistanceKernels::activeInstructionSet();
+        }
+        switch (dimension) {
+            case kRepresentationDimension<RepresentationId::Zernike7>: return select<Op, T, kRepresentationDimension<RepresentationId::Zernike7>>(isa);
+            case kRepresentationDimension<RepresentationId::Yang>:     return select<Op, T, kRepresentationDimension<RepresentationId::Yang>>(isa);
+            case kRepresentationDimension<RepresentationId::ART>:      return select<Op, T, kRepresentationDimension<RepresentationId::ART>>(isa);
+            case kRepresentationDimension<RepresentationId::GFD>:      return select<Op, T, kRepresentationDimension<RepresentationId::GFD>>(isa);
+            default:                                                  return select<Op, T, 0>(isa);
+        }
+    }
+
+    std::atomic<DistanceKernels::InstructionSet>& activeSlot() {
+        static std::atomic<DistanceKernels::InstructionSet> slot(DistanceKernels::detectInstructionSet());
+        return slot;
+    }
+}
+
+double DistanceKernels::squaredEuclidean(const double* a, const double* b, std::size_t size) {
+    return scalarDouble<SquaredDifference, 0>(a, b, size);
+}
+
+double DistanceKernels::squaredEuclidean(const float* a, const float* b, std::size_t size) {
+    return scalarFloat<SquaredDifference, 0>(a, b, size);
+}
+
+double DistanceKernels::manhattan(const double* a, const double* b, std::size_t size) {
+    return scalarDouble<AbsoluteDifference, 0>(a, b, size);
+}
+
+double DistanceKernels::manhattan(const float* a, const float* b, std::size_t size) {
+    return scalarFloat<AbsoluteDifference, 0>(a, b, size);
+}
+
+DistanceKernels::Kernel DistanceKernels::squaredEuclideanKernel(std::size_t dimension) {
+    return dispatch<SquaredDifference, double>(dimension, activeInstructionSet());
+}
+
+DistanceKernels::Kernel DistanceKernels::squaredEuclideanKernel(std::size_t dimension, InstructionSet isa) {
+    return dispatch<SquaredDifference, double>(dimension, isa);
+}
+
+DistanceKernels::Kernel DistanceKernels::manhattanKernel(std::size_t dimension) {
+    return dispatch<AbsoluteDifference, double>(dimension, activeInstructionSet());
+}
+
+DistanceKernels::Kernel DistanceKernels::manhattanKernel(std::size_t dimension, InstructionSet isa) {
+    return dispatch<AbsoluteDifference, double>(dimension, isa);
+}
+
+DistanceKernels::FloatKernel DistanceKernels::squaredEuclideanFloatKernel(std::size_t dimension) {
+    return dispatch<SquaredDifference, float>(dimension, activeInstructionSet());
+}
+
+DistanceKernels::FloatKernel DistanceKernels::squaredEuclideanFloatKernel(std::size_t dimension, InstructionSet isa) {
+    return dispatch<SquaredDifference, float>(dimension, isa);
+}
+
+DistanceKernels::FloatKernel DistanceKernels::manhattanFloatKernel(std::size_t dimension) {
+    return dispatch<AbsoluteDifference, float>(dimension, activeInstructionSet());
+}
+
+DistanceKernels::FloatKernel DistanceKernels::manhattanFloatKernel(std::size_t dimension, InstructionSet isa) {
+    return dispatch<AbsoluteDifference, float>(dimension, isa);
+}
+
+DistanceKernels::DotPanelKernel DistanceKernels::dotPanelKernel() {
+    return dotPanelKernel(activeInstructionSet());
+}
+
+DistanceKernels::DotPanelKernel DistanceKernels::dotPanelKernel(InstructionSet isa) {
+    if (!isSupported(isa)) {
+        isa = activeInstructionSet();
+    }
+    switch (isa) {
+#ifdef DISTANCE_KERNELS_X86
+        case InstructionSet::AVX512: return &avx512DotPanel;
+        case InstructionSet::AVX2:   return &avx2DotPanel;
+        case InstructionSet::SSE2:   return &sse2DotPanel;
+#endif
+        default:                     return &scalarDotPanel;
+    }
+}
+
+DistanceKernels::BoundedPanelKernel DistanceKernels::squaredEuclideanPanelKernel() {
+    return selectBoundedPanel<SquaredDifference>(activeInstructionSet());
+}
+
+DistanceKernels::BoundedPanelKernel DistanceKernels::squaredEuclideanPanelKernel(InstructionSet isa) {
+    return selectBoundedPanel<SquaredDifference>(isa);
+}
+
+DistanceKernels::BoundedPanelKernel DistanceKernels::manhattanPanelKernel() {
+    return selectBoundedPanel<AbsoluteDifference>(activeInstructionSet());
+}
+
+DistanceKernels::BoundedPanelKernel DistanceKernels::manhattanPanelKernel(InstructionSet isa) {
+    return selectBoundedPanel<AbsoluteDifference>(isa);
+}
+
+DistanceKernels::InstructionSet DistanceKernels::detectInstructionSet() {
+    static const InstructionSet detected = [] {
+#ifdef DISTANCE_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return InstructionSet::AVX512;
+        if (__builtin_cpu_supports("avx2")) return InstructionSet::AVX2;
+        if (__builtin_cpu_supports("sse2")) return InstructionSet::SSE2;
+#endif
+        return InstructionSet::Scalar;
+    }();
+    return detected;
+}
+
+DistanceKernels::InstructionSet DistanceKernels::activeInstructionSet() {
+    return activeSlot().load(std::memory_order_relaxed);
+}
+
+bool DistanceKernels::setInstructionSet(InstructionSet isa) {
+    if (!isSupported(isa)) {
+        return false;
+    }
+    activeSlot().store(isa, std::memory_order_relaxed);
+    return true;
+}
+
+bool DistanceKernels::isSupported(InstructionSet isa) {
+    // Chaque jeu d'instructions inclut les précédents.
+    return static_cast<int>(isa) <= static_cast<int>(detectInstructionSet());
+}
+
+const char* DistanceKernels::instructionSetName(InstructionSet isa) {
+    switch (isa) {
+        case InstructionSet::SSE2:   return "SSE2";
+        case InstructionSet::AVX2:   return "AVX2";
+        case InstructionSet::AVX512: return "AVX-512";
+        default:                     return "Scalaire";
+    }
+}
@@ -0,0 +1,32 @@
+#include "classifier/DistancePolicy.h"
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+DistanceMetric distanceMetricFromName(const string& name) {
+    if (name == "euclidean") return DistanceMetric::Euclidean;
+    if (name == "manhattan") return DistanceMetric::Manhattan;
+    cerr << "Type de distance non reconnu : " << name << endl;
+    throw invalid_argument("Type de distance non reconnu");
+}
+
+const char* distanceMetricName(DistanceMetric metric) {
+    return metric == DistanceMetric::Euclidean ? "euclidean" : "manhattan";
+}
+
+DistancePolicy::DistancePolicy()
+    : DistancePolicy(DistanceMetric::Euclidean, 0) {}
+
+DistancePolicy::DistancePolicy(DistanceMetric metric, size_t dimension)
+    : distanceMetric(metric), dim(dimension), kernel(resolve(metric, dimension)) {}
+
+double DistancePolicy::distance(const double* a, const double* b, size_t size) const {
+    DistanceKernels::Kernel sized = (size == dim) ? kernel : resolve(distanceMetric, size);
+    return finalize(sized(a, b, size));
+}
+
+DistanceKernels::Kernel DistancePolicy::resolve(DistanceMetric metric, size_t dimension) {
+    return metric == DistanceMetric::Euclidean ? DistanceKernels::squaredEuclideanKernel(dimension)
+                                               : DistanceKernels::manhattanKernel(dimension);
+}
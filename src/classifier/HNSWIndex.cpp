@@ -0,0 +1,293 @@
+#include "classifier/HNSWIndex.h"
+#include "parallel/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+
+using namespace std;
+
+namespace {
+    // Nombre de verrous de construction ; le nœud i utilise le verrou i % kLockStripes.
+    const size_t kLockStripes = 4096;
+    // Borne des niveaux tirés (jamais atteinte en pratique).
+    const int kMaxLevel = 32;
+}
+
+/**
+ * Tampons d'une recherche dans le graphe, réutilisés d'une requête à l'autre.
+ * `visited[i] == epoch` marque les nœuds déjà vus sans remettre le tableau à zéro.
+ */
+struct HNSWIndex::Scratch {
+    vector<uint32_t> visited;
+    uint32_t epoch = 0;
+    vector<Candidate> frontier;       // Tas min : nœuds à explorer.
+    vector<Candidate> results;        // Tas max : ef meilleurs nœuds vus.
+    vector<uint32_t> neighborCopy;    // Copie d'une liste de voisins lue sous verrou.
+    vector<Candidate> selected;
+
+    void begin(size_t nodes) {
+        if (visited.size() != nodes) {
+            visited.assign(nodes, 0);
+            epoch = 0;
+        }
+        if (++epoch == 0) {
+            fill(visited.begin(), visited.end(), 0);
+            epoch = 1;
+        }
+        frontier.clear();
+        results.clear();
+    }
+};
+
+HNSWIndex::HNSWIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy, const HNSWParameters& options)
+    : policy(distancePolicy), parameters(options), maxLinks(max<size_t>(2, options.M)),
+      maxBaseLinks(2 * max<size_t>(2, options.M)), entryPoint(0), topLevel(-1) {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    if (rows == 0) {
+        return;
+    }
+
+    points = FeatureMatrix(rows, dimension, data.getRepresentationId());
+    for (size_t i = 0; i < rows; ++i) {
+        copy(data.row(i), data.row(i) + dimension, points.mutableRow(i));
+        points.setLabel(i, data.label(i));
+    }
+
+    // Niveaux tirés à l'avance : ils ne dépendent que de la graine.
+    mt19937 gen(parameters.seed);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double levelScale = 1.0 / log(static_cast<double>(maxLinks));
+    levels.resize(rows);
+    upperLinks.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        levels[i] = min(kMaxLevel, static_cast<int>(floor(-log(1.0 - uniform(gen)) * levelScale)));
+        if (levels[i] > 0) {
+            upperLinks[i].assign(static_cast<size_t>(levels[i]) * (maxLinks + 1), 0);
+        }
+    }
+    baseLinks.assign(rows * (maxBaseLinks + 1), 0);
+
+    entryPoint = 0;
+    topLevel = levels[0];
+    nodeLocks = vector<mutex>(min(rows, kLockStripes));
+
+    unique_ptr<ThreadPool> privatePool;
+    ThreadPool& pool = ThreadPool::select(parameters.numThreads, privatePool);
+    vector<Scratch> scratches(pool.size());
+    pool.parallelFor(rows - 1, [this, &scratches](size_t i, size_t worker) {
+        insert(static_cast<uint32_t>(i + 1), scratches[worker]);
+    });
+
+    nodeLocks = vector<mutex>();
+}
+
+double HNSWIndex::distance(const double* query, uint32_t node) const {
+    return policy.rank(query, points.row(node));
+}
+
+uint32_t* HNSWIndex::links(uint32_t node, int level) {
+    if (level == 0) {
+        return baseLinks.data() + static_cast<size_t>(node) * (maxBaseLinks + 1);
+    }
+    return upperLinks[node].data() + static_cast<size_t>(level - 1) * (maxLinks + 1);
+}
+
+const uint32_t* HNSWIndex::links(uint32_t node, int level) const {
+    if (level == 0) {
+        return baseLinks.data() + static_cast<size_t>(node) * (maxBaseLinks + 1);
+    }
+    return upperLinks[node].data() + static_cast<size_t>(level - 1) * (maxLinks + 1);
+}
+
+const uint32_t* HNSWIndex::readLinks(uint32_t node, int level, bool locked, Scratch& scratch) const {
+    const uint32_t* list = links(node, level);
+    if (!locked) {
+        return list;
+    }
+    // Pendant la construction, la liste peut être modifiée par un autre thread : on la copie.
+    lock_guard<mutex> lock(nodeLocks[node % nodeLocks.size()]);
+    scratch.neighborCopy.assign(list, list + 1 + list[0]);
+    return scratch.neighborCopy.data();
+}
+
+void HNSWIndex::insert(uint32_t node, Scratch& scratch) {
+    const int level = levels[node];
+    const double* query = points.row(node);
+
+    int currentTop;
+    uint32_t current;
+    {
+        lock_guard<mutex> entryLock(entryMutex);
+        currentTop = topLevel;
+        current = entryPoint;
+    }
+
+    current = greedyDescent(query, current, currentTop, level + 1, true, scratch);
+
+    const size_t ef = max(parameters.efConstruction, maxLinks);
+    for (int l = min(level, currentTop); l >= 0; --l) {
+        searchLayer(query, current, ef, l, true, scratch);
+        vector<Candidate>& selected = scratch.selected;
+        selected.assign(scratch.results.begin(), scratch.results.end());
+        sort(selected.begin(), selected.end());
+        current = selected.front().second;
+        selectNeighbors(selected, maxLinks);
+
+        {
+            lock_guard<mutex> lock(nodeLocks[node % nodeLocks.size()]);
+            uint32_t* list = links(node, l);
+            list[0] = static_cast<uint32_t>(selected.size());
+            for (size_t i = 0; i < selected.size(); ++i) {
+                list[1 + i] = selected[i].second;
+            }
+        }
+        for (const Candidate& neighbor : selected) {
+            connect(neighbor.second, node, neighbor.first, l);
+        }
+    }
+
+    // Seule la mise à jour du point d'entrée est protégée. Deux nœuds qui dépassent le sommet en
+    // même temps ne sont pas reliés entre eux au-dessus de l'ancien sommet (cas rare : les deux
+    // restent reliés au graphe sur les niveaux inférieurs) ; le plus haut devient le point d'entrée.
+    if (level > currentTop) {
+        lock_guard<mutex> entryLock(entryMutex);
+        if (level > topLevel) {
+            entryPoint = node;
+            topLevel = level;
+        }
+    }
+}
+
+uint32_t HNSWIndex::greedyDescent(const double* query, uint32_t start, int fromLevel, int toLevel,
+                                  bool locked, Scratch& scratch) const {
+    uint32_t current = start;
+    double best = distance(query, current);
+    for (int level = fromLevel; level >= toLevel; --level) {
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            const uint32_t* list = readLinks(current, level, locked, scratch);
+            for (uint32_t i = 1; i <= list[0]; ++i) {
+                double d = distance(query, list[i]);
+                if (d < best) {
+                    best = d;
+                    current = list[i];
+                    improved = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+void HNSWIndex::searchLayer(const double* query, uint32_t start, size_t ef, int level, bool locked,
+                            Scratch& scratch) const {
+    scratch.begin(points.rows());
+    auto closerFirst = greater<Candidate>();
+
+    const Candidate first(distance(query, start), start);
+    scratch.visited[start] = scratch.epoch;
+    scratch.frontier.push_back(first);
+    scratch.results.push_back(first);
+
+    while (!scratch.frontier.empty()) {
+        pop_heap(scratch.frontier.begin(), scratch.frontier.end(), closerFirst);
+        const Candidate current = scratch.frontier.back();
+        scratch.frontier.pop_back();
+        if (scratch.results.size() >= ef && current.first > scratch.results.front().first) {
+            break;
+        }
+
+        const uint32_t* list = readLinks(current.second, level, locked, scratch);
+        for (uint32_t i = 1; i <= list[0]; ++i) {
+            const uint32_t neighbor = list[i];
+            if (scratch.visited[neighbor] == scratch.epoch) {
+                continue;
+            }
+            scratch.visited[neighbor] = scratch.epoch;
+
+            const double d = distance(query, neighbor);
+            if (scratch.results.size() < ef || d < scratch.results.front().first) {
+                scratch.frontier.emplace_back(d, neighbor);
+                push_heap(scratch.frontier.begin(), scratch.frontier.end(), closerFirst);
+                scratch.results.emplace_back(d, neighbor);
+                push_heap(scratch.results.begin(), scratch.results.end());
+                if (scratch.results.size() > ef) {
+                    pop_heap(scratch.results.begin(), scratch.results.end());
+                    scratch.results.pop_back();
+                }
+            }
+        }
+    }
+}
+
+void HNSWIndex::selectNeighbors(vector<Candidate>& candidates, size_t limit) const {
+    // Heuristique de l'article : un candidat est gardé s'il est plus proche du nœud que de
+    // tous les voisins déjà gardés, ce qui répartit les liens dans plusieurs directions.
+    // `candidates` est trié par distance croissante au nœud.
+    if (candidates.size() <= limit) {
+        return;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < candidates.size() && kept < limit; ++i) {
+        const double* candidate = points.row(candidates[i].second);
+        bool diverse = true;
+        for (size_t j = 0; j < kept; ++j) {
+            if (distance(candidate, candidates[j].second) < candidates[i].first) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) {
+            candidates[kept++] = candidates[i];
+        }
+    }
+    candidates.resize(kept);
+}
+
+void HNSWIndex::connect(uint32_t node, uint32_t neighbor, double neighborDistance, int level) {
+    const size_t limit = (level == 0) ? maxBaseLinks : maxLinks;
+    lock_guard<mutex> lock(nodeLocks[node % nodeLocks.size()]);
+    uint32_t* list = links(node, level);
+    if (list[0] < limit) {
+        list[1 + list[0]] = neighbor;
+        ++list[0];
+        return;
+    }
+
+    // Liste pleine : on garde les meilleurs voisins parmi les anciens et le nouveau.
+    vector<Candidate> candidates;
+    candidates.reserve(limit + 1);
+    const double* origin = points.row(node);
+    for (uint32_t i = 1; i <= list[0]; ++i) {
+        candidates.emplace_back(distance(origin, list[i]), list[i]);
+    }
+    candidates.emplace_back(neighborDistance, neighbor);
+    sort(candidates.begin(), candidates.end());
+    selectNeighbors(candidates, limit);
+
+    list[0] = static_cast<uint32_t>(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        list[1 + i] = candidates[i].second;
+    }
+}
+
+void HNSWIndex::search(const double* query, TopKSelector& selector) const {
+    if (topLevel < 0) {
+        return;
+    }
+    // Tampons réutilisés d'une requête à l'autre (un par thread). La recherche est sans verrou :
+    // le graphe ne change plus après la construction.
+    thread_local Scratch scratch;
+    uint32_t start = greedyDescent(query, entryPoint, topLevel, 1, false, scratch);
+    const size_t ef = max<size_t>(1, max(parameters.efSearch, selector.capacity()));
+    searchLayer(query, start, ef, 0, false, scratch);
+
+    for (const Candidate& candidate : scratch.results) {
+        if (candidate.first <= selector.threshold()) {
+            selector.push(candidate.first, points.label(candidate.second));
+        }
+    }
+}
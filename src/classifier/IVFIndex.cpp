@@ -0,0 +1,111 @@
+#include "classifier/IVFIndex.h"
+#include "classifier/KMeans.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+IVFIndex::IVFIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy, const IVFParameters& parameters)
+    : policy(distancePolicy), quantizer(DistanceMetric::Euclidean, data.dimension()), nprobe(parameters.nprobe) {
+    const size_t rows = data.rows();
+    if (rows == 0) {
+        return;
+    }
+
+    size_t lists = parameters.lists ? parameters.lists : static_cast<size_t>(sqrt(static_cast<double>(rows)));
+    lists = min(rows, max<size_t>(1, lists));
+
+    // Échantillon régulier des lignes pour l'apprentissage des centroids.
+    const size_t sampleSize = (parameters.trainingSample && parameters.trainingSample < rows) ? parameters.trainingSample : rows;
+    FeatureMatrix sample(sampleSize, data.dimension(), data.getRepresentationId());
+    for (size_t s = 0; s < sampleSize; ++s) {
+        const size_t i = s * rows / sampleSize;
+        copy(data.row(i), data.row(i) + data.dimension(), sample.mutableRow(s));
+        sample.setLabel(s, data.label(i));
+    }
+
+    KMeans kmeans(static_cast<int>(lists), static_cast<int>(data.dimension()), parameters.trainIterations);
+    kmeans.fit(sample);
+    centroids = kmeans.getCentroids(data.getRepresentationId());
+    partition(data);
+}
+
+IVFIndex::IVFIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy, const FeatureMatrix& trainedCentroids,
+                   size_t probes)
+    : policy(distancePolicy), quantizer(DistanceMetric::Euclidean, data.dimension()), nprobe(probes),
+      centroids(trainedCentroids) {
+    if (centroids.dimension() != data.dimension()) {
+        cerr << "Erreur : Centroids de dimension " << centroids.dimension() << " pour des descripteurs de dimension "
+             << data.dimension() << "." << endl;
+        throw invalid_argument("Centroids incompatibles avec les données de l'index IVF.");
+    }
+    if (!data.empty()) {
+        partition(data);
+    }
+}
+
+void IVFIndex::partition(const FeatureMatrix& data) {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    const size_t lists = centroids.rows();
+
+    // Liste de chaque ligne : centroid le plus proche, avec la distance de l'apprentissage KMeans.
+    vector<uint32_t> assignment(rows);
+    listBegin.assign(lists + 1, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        double best = numeric_limits<double>::infinity();
+        size_t closest = 0;
+        for (size_t c = 0; c < lists; ++c) {
+            double distance = quantizer.rank(data.row(i), centroids.row(c));
+            if (distance < best) {
+                best = distance;
+                closest = c;
+            }
+        }
+        assignment[i] = static_cast<uint32_t>(closest);
+        ++listBegin[closest + 1];
+    }
+    for (size_t c = 0; c < lists; ++c) {
+        listBegin[c + 1] += listBegin[c];
+    }
+
+    // Rangement stable : les lignes d'une liste gardent l'ordre du dataset.
+    points = FeatureMatrix(rows, dimension, data.getRepresentationId());
+    vector<size_t> next(listBegin.begin(), listBegin.end() - 1);
+    for (size_t i = 0; i < rows; ++i) {
+        const size_t target = next[assignment[i]]++;
+        copy(data.row(i), data.row(i) + dimension, points.mutableRow(target));
+        points.setLabel(target, data.label(i));
+    }
+}
+
+void IVFIndex::search(const double* query, TopKSelector& selector) const {
+    const size_t lists = centroids.rows();
+    if (lists == 0 || points.empty()) {
+        return;
+    }
+
+    // Listes les plus proches de la requête (un tampon par thread).
+    thread_local vector<pair<double, size_t>> order;
+    order.resize(lists);
+    for (size_t c = 0; c < lists; ++c) {
+        order[c] = make_pair(quantizer.rank(query, centroids.row(c)), c);
+    }
+    const size_t probes = min(lists, max<size_t>(1, nprobe));
+    partial_sort(order.begin(), order.begin() + probes, order.end());
+
+    DistanceKernels::Kernel kernel = policy.rankKernel();
+    const size_t dimension = points.dimension();
+    for (size_t p = 0; p < probes; ++p) {
+        const size_t list = order[p].second;
+        for (size_t i = listBegin[list]; i < listBegin[list + 1]; ++i) {
+            double distance = kernel(query, points.row(i), dimension);
+            if (distance <= selector.threshold()) {
+                selector.push(distance, points.label(i));
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include "classifier/KDTreeIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+    // Marge relative avant d'élaguer une cellule : la distance à la cellule est mise à jour par
+    // soustractions successives et peut dépasser de quelques ulps la vraie borne.
+    const double kPruneSlack = 1e-9;
+
+    template <DistanceMetric Metric>
+    inline double axisContribution(double offset) {
+        return Metric == DistanceMetric::Euclidean ? offset * offset : std::fabs(offset);
+    }
+
+    inline bool prunable(double cellDistance, double threshold) {
+        return cellDistance > threshold + threshold * kPruneSlack;
+    }
+}
+
+KDTreeIndex::KDTreeIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy, size_t maxLeafSize)
+    : policy(distancePolicy), leafSize(max<size_t>(1, maxLeafSize)), treeDepth(0) {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    if (rows == 0) {
+        return;
+    }
+
+    rootLower.assign(data.row(0), data.row(0) + dimension);
+    rootUpper = rootLower;
+    for (size_t i = 1; i < rows; ++i) {
+        const double* values = data.row(i);
+        for (size_t d = 0; d < dimension; ++d) {
+            rootLower[d] = min(rootLower[d], values[d]);
+            rootUpper[d] = max(rootUpper[d], values[d]);
+        }
+    }
+
+    vector<uint32_t> order(rows);
+    iota(order.begin(), order.end(), 0);
+    vector<double> lower = rootLower;
+    vector<double> upper = rootUpper;
+    nodes.reserve(2 * (rows / leafSize + 1));
+    build(order, data, 0, static_cast<uint32_t>(rows), lower, upper, 1);
+
+    points = FeatureMatrix(rows, dimension, data.getRepresentationId());
+    for (size_t i = 0; i < rows; ++i) {
+        const double* values = data.row(order[i]);
+        copy(values, values + dimension, points.mutableRow(i));
+        points.setLabel(i, data.label(order[i]));
+    }
+}
+
+int32_t KDTreeIndex::build(vector<uint32_t>& order, const FeatureMatrix& data, uint32_t begin, uint32_t end,
+                           vector<double>& lower, vector<double>& upper, size_t level) {
+    const int32_t nodeIndex = static_cast<int32_t>(nodes.size());
+    nodes.push_back(Node{begin, end, -1, -1, 0, 0.0});
+    treeDepth = max(treeDepth, level);
+    if (end - begin <= leafSize) {
+        return nodeIndex;
+    }
+
+    // Étendue des points sur chaque axe : on ne coupe que des axes où les points diffèrent.
+    const size_t dimension = data.dimension();
+    vector<double> pointMin(data.row(order[begin]), data.row(order[begin]) + dimension);
+    vector<double> pointMax = pointMin;
+    for (uint32_t i = begin + 1; i < end; ++i) {
+        const double* values = data.row(order[i]);
+        for (size_t d = 0; d < dimension; ++d) {
+            pointMin[d] = min(pointMin[d], values[d]);
+            pointMax[d] = max(pointMax[d], values[d]);
+        }
+    }
+
+    size_t splitDimension = dimension;
+    double widest = -1.0;
+    for (size_t d = 0; d < dimension; ++d) {
+        if (pointMax[d] > pointMin[d] && upper[d] - lower[d] > widest) {
+            widest = upper[d] - lower[d];
+            splitDimension = d;
+        }
+    }
+    if (splitDimension == dimension) {
+        return nodeIndex; // Points tous identiques : feuille.
+    }
+
+    auto valueOf = [&data, splitDimension](uint32_t row) { return data.row(row)[splitDimension]; };
+    double splitValue = 0.5 * (lower[splitDimension] + upper[splitDimension]);
+    auto first = order.begin() + begin;
+    auto last = order.begin() + end;
+    auto middle = partition(first, last, [&](uint32_t row) { return valueOf(row) < splitValue; });
+
+    // Glissement du plan vers le point le plus proche si un côté est vide.
+    if (middle == first) {
+        splitValue = pointMin[splitDimension];
+        middle = partition(first, last, [&](uint32_t row) { return valueOf(row) <= splitValue; });
+    } else if (middle == last) {
+        splitValue = pointMax[splitDimension];
+        middle = partition(first, last, [&](uint32_t row) { return valueOf(row) < splitValue; });
+    }
+    const uint32_t mid = static_cast<uint32_t>(middle - order.begin());
+
+    double savedUpper = upper[splitDimension];
+    upper[splitDimension] = splitValue;
+    int32_t left = build(order, data, begin, mid, lower, upper, level + 1);
+    upper[splitDimension] = savedUpper;
+
+    double savedLower = lower[splitDimension];
+    lower[splitDimension] = splitValue;
+    int32_t right = build(order, data, mid, end, lower, upper, level + 1);
+    lower[splitDimension] = savedLower;
+
+    Node& node = nodes[nodeIndex];
+    node.left = left;
+    node.right = right;
+    node.splitDimension = static_cast<uint32_t>(splitDimension);
+    node.splitValue = splitValue;
+    return nodeIndex;
+}
+
+void KDTreeIndex::search(const double* query, TopKSelector& selector) const {
+    if (nodes.empty()) {
+        return;
+    }
+    if (policy.metric() == DistanceMetric::Euclidean) {
+        searchFrom<DistanceMetric::Euclidean>(query, selector);
+    } else {
+        searchFrom<DistanceMetric::Manhattan>(query, selector);
+    }
+}
+
+template <DistanceMetric Metric>
+void KDTreeIndex::searchFrom(const double* query, TopKSelector& selector) const {
+    // Écart de la requête à la cellule courante sur chaque axe (un tableau par thread).
+    thread_local vector<double> offsets;
+    const size_t dimension = points.dimension();
+    offsets.assign(dimension, 0.0);
+
+    double cellDistance = 0.0;
+    for (size_t d = 0; d < dimension; ++d) {
+        if (query[d] < rootLower[d]) {
+            offsets[d] = query[d] - rootLower[d];
+        } else if (query[d] > rootUpper[d]) {
+            offsets[d] = query[d] - rootUpper[d];
+        }
+        cellDistance += axisContribution<Metric>(offsets[d]);
+    }
+    searchNode<Metric>(0, query, cellDistance, offsets.data(), selector);
+}
+
+template <DistanceMetric Metric>
+void KDTreeIndex::searchNode(int32_t nodeIndex, const double* query, double cellDistance, double* offsets,
+                             TopKSelector& selector) const {
+    const Node& node = nodes[nodeIndex];
+    if (node.left < 0) {
+        DistanceKernels::Kernel kernel = policy.rankKernel();
+        const size_t dimension = points.dimension();
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            double distance = kernel(query, points.row(i), dimension);
+            if (distance <= selector.threshold()) {
+                selector.push(distance, points.label(i));
+            }
+        }
+        return;
+    }
+
+    const uint32_t axis = node.splitDimension;
+    const double difference = query[axis] - node.splitValue;
+    const int32_t nearChild = difference < 0 ? node.left : node.right;
+    const int32_t farChild = difference < 0 ? node.right : node.left;
+
+    searchNode<Metric>(nearChild, query, cellDistance, offsets, selector);
+
+    const double previousOffset = offsets[axis];
+    const double farDistance = cellDistance - axisContribution<Metric>(previousOffset) + axisContribution<Metric>(difference);
+    if (!prunable(farDistance, selector.threshold())) {
+        offsets[axis] = difference;
+        searchNode<Metric>(farChild, query, farDistance, offsets, selector);
+        offsets[axis] = previousOffset;
+    }
+}
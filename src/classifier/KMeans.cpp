@@ -1,93 +1,729 @@
 #include "classifier/KMeans.h"
+#include "classifier/DistanceKernels.h"
+#include "dataRepo/DataCollection.h"
+#include "dataRepo/DescriptorBatchReader.h"
+#include "parallel/ThreadPool.h"
 #include <cmath>
 #include <limits>
 #include <random>
-#include <unordered_map>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 
-KMeans::KMeans(int numClusters, int numFeatures, int maxIterations, double tolerance)
-    : numClusters(numClusters), numFeatures(numFeatures), maxIterations(maxIterations), tolerance(tolerance) {}
+namespace {
+    // Lignes traitées par tâche dans les boucles parallèles.
+    const size_t kRowBlock = 1024;
 
-void KMeans::fit(const std::vector<Image>& images) {
-    std::unordered_map<std::string, std::vector<Image>> imagesByRepresentation;
-    for (const auto& image : images) {
-        imagesByRepresentation[image.getRepresentationType()].push_back(image);
-    }
-    for (const auto& pair : imagesByRepresentation) {
-        const std::string& representation = pair.first;
-        const std::vector<Image>& repImages = pair.second;
-
-        std::vector<std::vector<double>> centroids(numClusters, std::vector<double>(numFeatures, 0.0));
-        std::vector<int> assignments(repImages.size(), -1);
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(0, repImages.size() - 1);
-        for (int i = 0; i < numClusters; ++i) {
-            centroids[i] = repImages[dist(gen)].getDescripteurs();
-        }
-
-        bool converged = false;
-        for (int iteration = 0; iteration < maxIterations && !converged; ++iteration) {
-            converged = true;
-            for (size_t i = 0; i < repImages.size(); ++i) {
-                const auto& features = repImages[i].getDescripteurs();
+    // Nombre maximal de tranches de la mise à jour des centroids (sommes partielles de k x d valeurs chacune).
+    const size_t kMaxUpdateShards = 64;
+
+    size_t blockCount(size_t rows) {
+        return (rows + kRowBlock - 1) / kRowBlock;
+    }
+
+    // Exécute `task(begin, end)` sur des blocs de lignes consécutives.
+    template <typename Task>
+    void forEachBlock(ThreadPool& pool, size_t rows, const Task& task) {
+        pool.parallelFor(blockCount(rows), [&](size_t block, size_t) {
+            task(block * kRowBlock, std::min(rows, (block + 1) * kRowBlock));
+        });
+    }
+
+    // Somme de `term(i)` sur [0, rows) : sommes par bloc, additionnées dans l'ordre des blocs (même
+    // résultat quel que soit le nombre de threads, et celui de la boucle séquentielle jusqu'à kRowBlock lignes).
+    template <typename Term>
+    double blockSum(ThreadPool& pool, size_t rows, const Term& term) {
+        std::vector<double> partial(blockCount(rows), 0.0);
+        forEachBlock(pool, rows, [&](size_t begin, size_t end) {
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                sum += term(i);
+            }
+            partial[begin / kRowBlock] = sum;
+        });
+        double total = 0.0;
+        for (double sum : partial) {
+            total += sum;
+        }
+        return total;
+    }
+
+    // Threads d'une opération sur `rows` lignes (voir `ThreadPool::select`) : pas de thread
+    // auxiliaire pour un seul bloc.
+    size_t threadsFor(size_t rows, size_t numThreads) {
+        return rows > kRowBlock ? numThreads : 1;
+    }
+
+    // Réel uniforme dans [0, 1) tiré des 53 bits de poids fort : contrairement aux distributions
+    // de <random>, la suite obtenue pour une graine ne dépend pas de la bibliothèque standard.
+    double unitRandom(std::mt19937_64& gen) {
+        return static_cast<double>(gen() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Réel uniforme dans [0, 1) ne dépendant que de (graine, passe, ligne) : le tirage d'une ligne
+    // ne dépend pas de l'ordre de parcours des threads (splitmix64).
+    double hashedUnit(std::uint64_t seed, std::uint64_t round, std::uint64_t row) {
+        std::uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (round * 0x100000001b3ULL + row + 1);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        return static_cast<double>(z >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Index tiré avec une probabilité proportionnelle à mass[i] (uniforme si la masse totale est nulle).
+    size_t sampleIndex(const std::vector<double>& mass, double total, std::mt19937_64& gen) {
+        const size_t count = mass.size();
+        if (!(total > 0.0)) {
+            return std::min(count - 1, static_cast<size_t>(unitRandom(gen) * count));
+        }
+        double target = unitRandom(gen) * total;
+        size_t last = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (mass[i] > 0.0) {
+                last = i;
+                target -= mass[i];
+                if (target < 0.0) {
+                    return i;
+                }
+            }
+        }
+        return last;  // Arrondi de la somme : dernière ligne de masse non nulle.
+    }
+
+    /**
+     * k-means++ glouton : chaque nouveau centre est, parmi 2 + ln(count) lignes tirées avec une
+     * probabilité proportionnelle à poids x distance² au centre le plus proche, celle qui réduit le
+     * plus l'inertie.
+     * Entrée :
+     *   - points (FeatureMatrix&) : Lignes candidates.
+     *   - weights (std::vector<double>&) : Poids de chaque ligne (vide = tous à 1).
+     *   - count (size_t) : Nombre de centres.
+     *   - gen (std::mt19937_64&) : Générateur.
+     *   - squaredDistance (Kernel) : Distance euclidienne au carré.
+     *   - pool (ThreadPool&) : Pool des calculs de distances.
+     * Sortie (std::vector<size_t>) : Index des lignes choisies.
+     */
+    std::vector<size_t> kMeansPlusPlus(const FeatureMatrix& points, const std::vector<double>& weights, size_t count,
+                                       std::mt19937_64& gen, DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+        const size_t rows = points.rows();
+        const size_t dimension = points.dimension();
+        auto weight = [&weights](size_t i) { return weights.empty() ? 1.0 : weights[i]; };
+
+        std::vector<double> mass(rows);
+        double total = 0.0;
+        for (size_t i = 0; i < rows; ++i) {
+            mass[i] = weight(i);
+            total += mass[i];
+        }
+        std::vector<size_t> chosen;
+        if (count == 0 || rows == 0) {
+            return chosen;
+        }
+        chosen.push_back(sampleIndex(mass, total, gen));
+
+        std::vector<double> closest(rows);
+        const double* first = points.row(chosen[0]);
+        forEachBlock(pool, rows, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                closest[i] = squaredDistance(points.row(i), first, dimension);
+            }
+        });
+
+        const size_t trials = 2 + static_cast<size_t>(std::log(static_cast<double>(count)));
+        std::vector<double> trialClosest(rows);
+        std::vector<double> bestClosest(rows);
+        while (chosen.size() < count) {
+            total = 0.0;
+            for (size_t i = 0; i < rows; ++i) {
+                mass[i] = weight(i) * closest[i];
+                total += mass[i];
+            }
+            size_t bestCandidate = 0;
+            double bestPotential = std::numeric_limits<double>::infinity();
+            for (size_t t = 0; t < trials; ++t) {
+                const size_t candidate = sampleIndex(mass, total, gen);
+                const double* center = points.row(candidate);
+                const double potential = blockSum(pool, rows, [&](size_t i) {
+                    trialClosest[i] = std::min(closest[i], squaredDistance(points.row(i), center, dimension));
+                    return weight(i) * trialClosest[i];
+                });
+                if (potential < bestPotential) {
+                    bestPotential = potential;
+                    bestCandidate = candidate;
+                    bestClosest.swap(trialClosest);
+                }
+            }
+            chosen.push_back(bestCandidate);
+            closest.swap(bestClosest);
+        }
+        return chosen;
+    }
+
+    /**
+     * k-means|| : à chaque passe, chaque ligne devient candidate avec la probabilité
+     * oversampling x distance² / inertie (tirages indépendants, en parallèle). Les candidats sont
+     * pondérés par le nombre de lignes dont ils sont le plus proche, puis réduits à `count` centres
+     * par k-means++ pondéré.
+     * Sortie (std::vector<size_t>) : Index des lignes choisies.
+     */
+    std::vector<size_t> kMeansParallel(const FeatureMatrix& points, size_t count, const KMeansOptions& options,
+                                       std::mt19937_64& gen, DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+        const size_t rows = points.rows();
+        const size_t dimension = points.dimension();
+        const double oversampling = static_cast<double>(options.oversampling ? options.oversampling : 2 * count);
+
+        std::vector<size_t> candidates{std::min(rows - 1, static_cast<size_t>(unitRandom(gen) * rows))};
+        std::vector<double> closest(rows, std::numeric_limits<double>::infinity());
+        std::vector<size_t> nearest(rows, 0);
+        auto updateClosest = [&](size_t firstNew) {
+            forEachBlock(pool, rows, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    for (size_t c = firstNew; c < candidates.size(); ++c) {
+                        double distance = squaredDistance(points.row(i), points.row(candidates[c]), dimension);
+                        if (distance < closest[i]) {
+                            closest[i] = distance;
+                            nearest[i] = c;
+                        }
+                    }
+                }
+            });
+        };
+        updateClosest(0);
+
+        const std::uint64_t roundSeed = gen();
+        std::vector<char> picked(rows);
+        for (size_t round = 0; round < options.initRounds; ++round) {
+            double potential = 0.0;
+            for (size_t i = 0; i < rows; ++i) {
+                potential += closest[i];
+            }
+            if (!(potential > 0.0)) {
+                break;
+            }
+            forEachBlock(pool, rows, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    picked[i] = hashedUnit(roundSeed, round, i) < oversampling * closest[i] / potential;
+                }
+            });
+            const size_t firstNew = candidates.size();
+            for (size_t i = 0; i < rows; ++i) {
+                if (picked[i]) {
+                    candidates.push_back(i);
+                }
+            }
+            updateClosest(firstNew);
+        }
+
+        // Trop peu de candidats distincts (lignes presque toutes identiques) : k-means++ sur tout le dataset.
+        if (candidates.size() < count) {
+            return kMeansPlusPlus(points, std::vector<double>(), count, gen, squaredDistance, pool);
+        }
+
+        FeatureMatrix candidatePoints(candidates.size(), dimension, points.getRepresentationId());
+        std::vector<double> weights(candidates.size(), 0.0);
+        for (size_t c = 0; c < candidates.size(); ++c) {
+            std::copy(points.row(candidates[c]), points.row(candidates[c]) + dimension, candidatePoints.mutableRow(c));
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            weights[nearest[i]] += 1.0;
+        }
+        std::vector<size_t> chosen = kMeansPlusPlus(candidatePoints, weights, count, gen, squaredDistance, pool);
+        for (size_t& index : chosen) {
+            index = candidates[index];
+        }
+        return chosen;
+    }
+
+    /**
+     * Assignation de Lloyd : chaque ligne va au centroid de plus petite distance au carré (à égalité,
+     * le plus petit index).
+     * Sortie (bool) : true si une assignation a changé.
+     */
+    bool assignLloyd(const FeatureMatrix& data, const FeatureMatrix& centroids, std::vector<int>& assignments,
+                     DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+        const size_t dimension = data.dimension();
+        std::atomic<bool> changed(false);
+        forEachBlock(pool, data.rows(), [&](size_t begin, size_t end) {
+            bool blockChanged = false;
+            for (size_t i = begin; i < end; ++i) {
+                const double* features = data.row(i);
                 double minDistance = std::numeric_limits<double>::max();
                 int closestCluster = -1;
 
-                for (int j = 0; j < numClusters; ++j) {
-                    double distance = calculateDistance(features, centroids[j]);
+                for (size_t j = 0; j < centroids.rows(); ++j) {
+                    double distance = squaredDistance(features, centroids.row(j), dimension);
                     if (distance < minDistance) {
                         minDistance = distance;
-                        closestCluster = j;
+                        closestCluster = static_cast<int>(j);
                     }
                 }
 
                 if (assignments[i] != closestCluster) {
                     assignments[i] = closestCluster;
-                    converged = false;
+                    blockChanged = true;
+                }
+            }
+            if (blockChanged) {
+                changed = true;
+            }
+        });
+        return changed;
+    }
+
+    /**
+     * Étape de mise à jour : moyenne des lignes de chaque cluster. Les lignes sont découpées en
+     * tranches fixes (selon le nombre de lignes seulement) ; chaque tranche somme ses lignes dans
+     * l'ordre, puis les sommes des tranches sont additionnées dans l'ordre des tranches. Les
+     * centroids ne dépendent donc pas du nombre de threads.
+     */
+    class CentroidAccumulator {
+    public:
+        CentroidAccumulator(size_t rows, size_t clusters, size_t dimension)
+            : rows(rows), clusters(clusters), dimension(dimension),
+              shards(std::max<size_t>(1, std::min(blockCount(rows), kMaxUpdateShards))),
+              sums(shards * clusters * dimension, 0.0), sizes(shards * clusters, 0) {}
+
+        /**
+         * Sortie (FeatureMatrix) : Nouveaux centroids ; un cluster vide garde son ancien centroid
+         * plutôt que l'origine.
+         */
+        FeatureMatrix update(const FeatureMatrix& data, const FeatureMatrix& previous, const std::vector<int>& assignments,
+                             ThreadPool& pool) {
+            pool.parallelFor(shards, [&](size_t shard, size_t) {
+                double* shardSums = sums.data() + shard * clusters * dimension;
+                size_t* shardSizes = sizes.data() + shard * clusters;
+                std::fill(shardSums, shardSums + clusters * dimension, 0.0);
+                std::fill(shardSizes, shardSizes + clusters, 0);
+                for (size_t i = shard * rows / shards; i < (shard + 1) * rows / shards; ++i) {
+                    const size_t cluster = static_cast<size_t>(assignments[i]);
+                    const double* features = data.row(i);
+                    double* sum = shardSums + cluster * dimension;
+                    for (size_t j = 0; j < dimension; ++j) {
+                        sum[j] += features[j];
+                    }
+                    ++shardSizes[cluster];
+                }
+            });
+
+            FeatureMatrix centroids(clusters, dimension, previous.getRepresentationId());
+            pool.parallelFor(clusters, [&](size_t c, size_t) {
+                double* centroid = centroids.mutableRow(c);
+                size_t size = 0;
+                for (size_t shard = 0; shard < shards; ++shard) {
+                    const double* sum = sums.data() + (shard * clusters + c) * dimension;
+                    for (size_t j = 0; j < dimension; ++j) {
+                        centroid[j] += sum[j];
+                    }
+                    size += sizes[shard * clusters + c];
+                }
+                if (size > 0) {
+                    for (size_t j = 0; j < dimension; ++j) {
+                        centroid[j] /= size;
+                    }
+                } else {
+                    std::copy(previous.row(c), previous.row(c) + dimension, centroid);
+                }
+            });
+            return centroids;
+        }
+
+    private:
+        size_t rows;
+        size_t clusters;
+        size_t dimension;
+        size_t shards;
+        std::vector<double> sums;   // Tranche s, cluster c : sums[(s * k + c) * d + j].
+        std::vector<size_t> sizes;  // Tranche s, cluster c : sizes[s * k + c].
+    };
+
+    // Marge relative des bornes : elles cumulent les arrondis des racines et des déplacements.
+    const double kBoundSlack = 1e-9;
+
+    // a < b même en tenant compte des arrondis : un centroid à distance >= b est strictement plus
+    // loin qu'un centroid à distance <= a, et ne peut pas gagner l'assignation (même à égalité d'index).
+    bool clearlyBelow(double a, double b) {
+        return a < b - kBoundSlack * (a + b);
+    }
+
+    /**
+     * Bornes de l'assignation accélérée (vraies distances, pas leurs carrés).
+     * - Hamerly : borne supérieure de la distance au centroid assigné, borne inférieure de la
+     *   distance au deuxième plus proche.
+     * - Elkan : borne supérieure, et une borne inférieure par centroid.
+     * Une ligne (ou un centroid) n'est recalculé que si les bornes, la demi-distance au centroid le
+     * plus proche du centroid assigné ou la demi-distance entre les deux centroids ne suffisent pas
+     * à l'écarter. Les distances recalculées utilisent le même noyau et la même règle d'égalité que
+     * Lloyd : les assignations sont identiques.
+     */
+    class TriangleBounds {
+    public:
+        TriangleBounds(bool elkanBounds, size_t rows, size_t clusters)
+            : elkan(elkanBounds), clusters(clusters), upper(rows, 0.0), lower(rows * (elkanBounds ? clusters : 1), 0.0),
+              centerDistances(clusters * clusters, 0.0), halfSeparation(clusters, 0.0), drift(clusters, 0.0),
+              evaluations(0) {}
+
+        /**
+         * Sortie (bool) : true si une assignation a changé.
+         * Chaque ligne ne touche que ses propres bornes : les blocs de lignes sont traités en parallèle.
+         */
+        bool assign(const FeatureMatrix& data, const FeatureMatrix& centroids, std::vector<int>& assignments,
+                    DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+            computeSeparation(centroids, squaredDistance, pool);
+            std::atomic<bool> changed(false);
+            std::atomic<size_t> computed(0);
+            forEachBlock(pool, data.rows(), [&](size_t begin, size_t end) {
+                std::vector<double> scratch(clusters);
+                size_t blockEvaluations = 0;
+                bool blockChanged = false;
+                for (size_t i = begin; i < end; ++i) {
+                    const int before = assignments[i];
+                    if (before < 0) {
+                        assignAll(data.row(i), i, centroids, assignments, squaredDistance, scratch, blockEvaluations);
+                    } else if (elkan) {
+                        assignElkan(data.row(i), i, centroids, assignments, squaredDistance, blockEvaluations);
+                    } else {
+                        assignHamerly(data.row(i), i, centroids, assignments, squaredDistance, scratch, blockEvaluations);
+                    }
+                    blockChanged = blockChanged || assignments[i] != before;
+                }
+                computed += blockEvaluations;
+                if (blockChanged) {
+                    changed = true;
+                }
+            });
+            evaluations += computed;
+            return changed;
+        }
+
+        /**
+         * Relâche les bornes du déplacement de chaque centroid (`before` -> `after`).
+         */
+        void moveCentroids(const FeatureMatrix& before, const FeatureMatrix& after, const std::vector<int>& assignments,
+                           DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+            double largest = 0.0;
+            double secondLargest = 0.0;
+            size_t farthest = 0;
+            for (size_t c = 0; c < clusters; ++c) {
+                drift[c] = std::sqrt(squaredDistance(before.row(c), after.row(c), before.dimension()));
+                if (drift[c] > largest) {
+                    secondLargest = largest;
+                    largest = drift[c];
+                    farthest = c;
+                } else if (drift[c] > secondLargest) {
+                    secondLargest = drift[c];
                 }
             }
+            forEachBlock(pool, upper.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    const size_t a = static_cast<size_t>(assignments[i]);
+                    upper[i] += drift[a];
+                    if (elkan) {
+                        double* bounds = lower.data() + i * clusters;
+                        for (size_t c = 0; c < clusters; ++c) {
+                            bounds[c] = std::max(0.0, bounds[c] - drift[c]);
+                        }
+                    } else {
+                        lower[i] = std::max(0.0, lower[i] - (a == farthest ? secondLargest : largest));
+                    }
+                }
+            });
+        }
+
+        size_t distanceEvaluations() const { return evaluations; }
+
+    private:
+        bool elkan;
+        size_t clusters;
+        std::vector<double> upper;            // Ligne i : borne supérieure de la distance à son centroid.
+        std::vector<double> lower;            // Hamerly : lower[i] ; Elkan : lower[i * k + c].
+        std::vector<double> centerDistances;  // Distances entre centroids (c * k + c').
+        std::vector<double> halfSeparation;   // Moitié de la distance de chaque centroid au plus proche autre.
+        std::vector<double> drift;            // Déplacement de chaque centroid à la dernière mise à jour.
+        size_t evaluations;
 
-            // Mettre à jour les centroids
-            std::vector<std::vector<double>> newCentroids(numClusters, std::vector<double>(numFeatures, 0.0));
-            std::vector<int> clusterSizes(numClusters, 0);
+        // Chaque tâche remplit la ligne c de la matrice des distances ; la distance entre deux
+        // centroids est calculée deux fois, mais sans écriture partagée.
+        void computeSeparation(const FeatureMatrix& centroids, DistanceKernels::Kernel squaredDistance, ThreadPool& pool) {
+            pool.parallelFor(clusters, [&](size_t c, size_t) {
+                halfSeparation[c] = std::numeric_limits<double>::infinity();
+                for (size_t other = 0; other < clusters; ++other) {
+                    if (other == c) {
+                        continue;
+                    }
+                    double distance = std::sqrt(squaredDistance(centroids.row(c), centroids.row(other), centroids.dimension()));
+                    centerDistances[c * clusters + other] = distance;
+                    halfSeparation[c] = std::min(halfSeparation[c], 0.5 * distance);
+                }
+            });
+        }
 
-            for (size_t i = 0; i < repImages.size(); ++i) {
-                int cluster = assignments[i];
-                const auto& features = repImages[i].getDescripteurs();
-                for (int j = 0; j < numFeatures; ++j) {
-                    newCentroids[cluster][j] += features[j];
+        // Calcule toutes les distances de la ligne i (première itération, ou bornes Hamerly insuffisantes).
+        void assignAll(const double* features, size_t i, const FeatureMatrix& centroids, std::vector<int>& assignments,
+                       DistanceKernels::Kernel squaredDistance, std::vector<double>& scratch, size_t& computed) {
+            double minDistance = std::numeric_limits<double>::max();
+            size_t closest = 0;
+            for (size_t c = 0; c < clusters; ++c) {
+                scratch[c] = squaredDistance(features, centroids.row(c), centroids.dimension());
+                if (scratch[c] < minDistance) {
+                    minDistance = scratch[c];
+                    closest = c;
                 }
-                ++clusterSizes[cluster];
             }
+            computed += clusters;
+            assignments[i] = static_cast<int>(closest);
+            upper[i] = std::sqrt(scratch[closest]);
+            if (elkan) {
+                for (size_t c = 0; c < clusters; ++c) {
+                    lower[i * clusters + c] = std::sqrt(scratch[c]);
+                }
+            } else {
+                double second = std::numeric_limits<double>::infinity();
+                for (size_t c = 0; c < clusters; ++c) {
+                    if (c != closest) {
+                        second = std::min(second, scratch[c]);
+                    }
+                }
+                lower[i] = std::sqrt(second);
+            }
+        }
+
+        void assignHamerly(const double* features, size_t i, const FeatureMatrix& centroids, std::vector<int>& assignments,
+                           DistanceKernels::Kernel squaredDistance, std::vector<double>& scratch, size_t& computed) {
+            const size_t a = static_cast<size_t>(assignments[i]);
+            const double bound = std::max(halfSeparation[a], lower[i]);
+            if (clearlyBelow(upper[i], bound)) {
+                return;
+            }
+            upper[i] = std::sqrt(squaredDistance(features, centroids.row(a), centroids.dimension()));
+            ++computed;
+            if (clearlyBelow(upper[i], bound)) {
+                return;
+            }
+            assignAll(features, i, centroids, assignments, squaredDistance, scratch, computed);
+        }
 
-            for (int j = 0; j < numClusters; ++j) {
-                if (clusterSizes[j] > 0) {
-                    for (int k = 0; k < numFeatures; ++k) {
-                        newCentroids[j][k] /= clusterSizes[j];
+        void assignElkan(const double* features, size_t i, const FeatureMatrix& centroids, std::vector<int>& assignments,
+                         DistanceKernels::Kernel squaredDistance, size_t& computed) {
+            size_t a = static_cast<size_t>(assignments[i]);
+            double bestUpper = upper[i];
+            if (clearlyBelow(bestUpper, halfSeparation[a])) {
+                return;
+            }
+            double* bounds = lower.data() + i * clusters;
+            bool tight = false;
+            double bestSquared = 0.0;
+            for (size_t c = 0; c < clusters; ++c) {
+                if (c == a || clearlyBelow(bestUpper, std::max(bounds[c], 0.5 * centerDistances[a * clusters + c]))) {
+                    continue;
+                }
+                if (!tight) {
+                    bestSquared = squaredDistance(features, centroids.row(a), centroids.dimension());
+                    bestUpper = std::sqrt(bestSquared);
+                    bounds[a] = bestUpper;
+                    tight = true;
+                    ++computed;
+                    if (clearlyBelow(bestUpper, std::max(bounds[c], 0.5 * centerDistances[a * clusters + c]))) {
+                        continue;
                     }
                 }
+                const double squared = squaredDistance(features, centroids.row(c), centroids.dimension());
+                bounds[c] = std::sqrt(squared);
+                ++computed;
+                // Même règle que Lloyd : plus petite distance au carré, puis plus petit index.
+                if (squared < bestSquared || (squared == bestSquared && c < a)) {
+                    a = c;
+                    bestSquared = squared;
+                    bestUpper = bounds[c];
+                }
             }
+            upper[i] = bestUpper;
+            assignments[i] = static_cast<int>(a);
+        }
+    };
+}
 
-            centroids = newCentroids;
+KMeans::KMeans(int numClusters, int numFeatures, int maxIterations, double tolerance, const KMeansOptions& options)
+    : numClusters(numClusters), numFeatures(numFeatures), maxIterations(maxIterations), tolerance(tolerance),
+      options(options) {}
+
+void KMeans::fit(const std::vector<Image>& images) {
+    // Index des images de chaque représentation : les descripteurs ne sont copiés qu'une fois, dans la matrice.
+    std::array<std::vector<size_t>, kRepresentationCount> imagesByRepresentation;
+    for (size_t i = 0; i < images.size(); ++i) {
+        imagesByRepresentation[representationIndex(images[i].getRepresentationId())].push_back(i);
+    }
+    std::array<FeatureMatrix, kRepresentationCount> matrices;
+    std::vector<size_t> slots;
+    for (size_t slot = 0; slot < kRepresentationCount; ++slot) {
+        const std::vector<size_t>& members = imagesByRepresentation[slot];
+        if (members.empty()) {
+            continue;
+        }
+        const Image& first = images[members[0]];
+        matrices[slot] = FeatureMatrix(members.size(), first.getDescripteurs().size(), first.getRepresentationId());
+        for (size_t row = 0; row < members.size(); ++row) {
+            const Image& image = images[members[row]];
+            matrices[slot].setRow(row, image.getDescripteurs(), image.getLabel(), image.getImagePath());
         }
+        slots.push_back(slot);
+    }
+
+    // Les représentations sont indépendantes : elles sont entraînées en même temps, sur le même pool
+    // (choisi d'après options.numThreads seul ; `fitRepresentation` limite les petites étapes).
+    ThreadPool& pool = ThreadPool::select(options.numThreads, ownPool);
+    pool.parallelFor(slots.size(), [&](size_t i, size_t) {
+        fitRepresentation(matrices[slots[i]], pool);
+    });
+}
 
-        associateLabelsToCentroids(repImages, assignments, centroids);
+void KMeans::fit(const FeatureMatrix& data) {
+    if (data.empty()) {
+        std::cerr << "Erreur : Aucune donnée fournie à KMeans." << std::endl;
+        return;
+    }
 
-        centroidsByRepresentation[representation] = centroids;
+    if (data.layout() != FeatureMatrix::Layout::RowMajor) {
+        fit(data.toLayout(FeatureMatrix::Layout::RowMajor));
+        return;
     }
+
+    fitRepresentation(data, ThreadPool::select(options.numThreads, ownPool));
 }
 
-void KMeans::associateLabelsToCentroids(const std::vector<Image>& images, const std::vector<int>& assignments, const std::vector<std::vector<double>>& centroids) {
+void KMeans::fitRepresentation(const FeatureMatrix& data, ThreadPool& pool) {
+    const FeatureMatrix& rows = data;
+    const RepresentationId representation = rows.getRepresentationId();
+    const size_t dimension = rows.dimension();
+    if (dimension != static_cast<size_t>(numFeatures)) {
+        std::cerr << "Avertissement : KMeans configuré pour " << numFeatures << " descripteurs, "
+                  << dimension << " trouvés pour " << representationName(representation) << "." << std::endl;
+    }
+
+    // Étapes par blocs de lignes : pas de thread auxiliaire pour un seul bloc.
+    ThreadPool& stepPool = rows.rows() > kRowBlock ? pool : ThreadPool::sequential();
+
+    // Entraînements indépendants en parallèle sur `pool`, quelle que soit la taille des données ; le
+    // premier d'inertie minimale est gardé, quel que soit l'ordre dans lequel ils se terminent.
+    const size_t restarts = std::max<size_t>(1, options.nInit);
+    std::vector<FeatureMatrix> restartCentroids(restarts);
+    std::vector<std::vector<int>> restartAssignments(restarts);
+    std::vector<KMeansRestart> summaries(restarts);
+    pool.parallelFor(restarts, [&](size_t r, size_t) {
+        fitOnce(rows, options.seed + r, stepPool, restartCentroids[r], restartAssignments[r], summaries[r]);
+    });
+    size_t best = 0;
+    for (size_t r = 1; r < restarts; ++r) {
+        if (summaries[r].inertia < summaries[best].inertia) {
+            best = r;
+        }
+    }
+    const std::vector<int>& assignments = restartAssignments[best];
+
+    associateLabelsToCentroids(rows, assignments);
+
+    const size_t slot = representationIndex(representation);
+    clusterWeightsByRepresentation[slot].assign(numClusters, 0.0);
+    for (int cluster : assignments) {
+        clusterWeightsByRepresentation[slot][cluster] += 1.0;
+    }
+    centroidsByRepresentation[slot] = std::move(restartCentroids[best]);
+    iterationsByRepresentation[slot] = summaries[best].iterations;
+    inertiaByRepresentation[slot] = summaries[best].inertia;
+    distanceEvaluationsByRepresentation[slot] = summaries[best].distanceEvaluations;
+    restartsByRepresentation[slot] = std::move(summaries);
+    bestRestartByRepresentation[slot] = best;
+}
+
+void KMeans::fitOnce(const FeatureMatrix& rows, std::uint64_t seed, ThreadPool& pool, FeatureMatrix& centroids,
+                     std::vector<int>& assignments, KMeansRestart& summary) const {
+    const size_t dimension = rows.dimension();
+    centroids = seedCentroids(rows, seed, pool);
+    assignments.assign(rows.rows(), -1);
+
+    KMeansOptions::Algorithm algorithm = options.algorithm;
+    if (algorithm == KMeansOptions::Algorithm::Auto) {
+        algorithm = static_cast<size_t>(numClusters) < KMeansOptions::kElkanMinClusters ? KMeansOptions::Algorithm::Hamerly
+                                                                                        : KMeansOptions::Algorithm::Elkan;
+    }
+    const bool accelerated = algorithm != KMeansOptions::Algorithm::Lloyd;
+    TriangleBounds bounds(algorithm == KMeansOptions::Algorithm::Elkan, accelerated ? rows.rows() : 0,
+                          accelerated ? static_cast<size_t>(numClusters) : 0);
+    size_t lloydEvaluations = 0;
+    CentroidAccumulator accumulator(rows.rows(), static_cast<size_t>(numClusters), dimension);
+
+    // Noyau résolu une fois ; l'assignation compare des distances au carré (même ordre).
+    const DistanceKernels::Kernel squaredDistance = DistanceKernels::squaredEuclideanKernel(dimension);
+    bool converged = false;
+    int iterations = 0;
+    for (; iterations < maxIterations && !converged; ++iterations) {
+        if (accelerated) {
+            converged = !bounds.assign(rows, centroids, assignments, squaredDistance, pool);
+        } else {
+            converged = !assignLloyd(rows, centroids, assignments, squaredDistance, pool);
+            lloydEvaluations += rows.rows() * static_cast<size_t>(numClusters);
+        }
+
+        // Mettre à jour les centroids
+        FeatureMatrix newCentroids = accumulator.update(rows, centroids, assignments, pool);
+
+        if (accelerated && !converged) {
+            bounds.moveCentroids(centroids, newCentroids, assignments, squaredDistance, pool);
+        }
+        centroids = std::move(newCentroids);
+    }
+
+    summary.seed = seed;
+    summary.iterations = iterations;
+    summary.inertia = blockSum(pool, rows.rows(), [&](size_t i) {
+        return squaredDistance(rows.row(i), centroids.row(assignments[i]), dimension);
+    });
+    summary.distanceEvaluations = accelerated ? bounds.distanceEvaluations() : lloydEvaluations;
+}
+
+FeatureMatrix KMeans::seedCentroids(const FeatureMatrix& data, std::uint64_t seed, ThreadPool& pool) const {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    const size_t count = static_cast<size_t>(numClusters);
+    const DistanceKernels::Kernel squaredDistance = DistanceKernels::squaredEuclideanKernel(dimension);
+    std::mt19937_64 gen(seed);
+
+    KMeansOptions::Init init = options.init;
+    if (init == KMeansOptions::Init::Auto) {
+        init = rows <= KMeansOptions::kParallelInitRows ? KMeansOptions::Init::KMeansPlusPlus
+                                                        : KMeansOptions::Init::KMeansParallel;
+    }
+
+    std::vector<size_t> chosen;
+    if (init == KMeansOptions::Init::KMeansPlusPlus) {
+        chosen = kMeansPlusPlus(data, std::vector<double>(), count, gen, squaredDistance, pool);
+    } else if (init == KMeansOptions::Init::KMeansParallel) {
+        chosen = kMeansParallel(data, count, options, gen, squaredDistance, pool);
+    } else {
+        for (size_t c = 0; c < count; ++c) {
+            chosen.push_back(std::min(rows - 1, static_cast<size_t>(unitRandom(gen) * rows)));
+        }
+    }
+
+    FeatureMatrix centroids(count, dimension, data.getRepresentationId());
+    for (size_t c = 0; c < count; ++c) {
+        std::copy(data.row(chosen[c]), data.row(chosen[c]) + dimension, centroids.mutableRow(c));
+    }
+    return centroids;
+}
+
+void KMeans::associateLabelsToCentroids(const FeatureMatrix& data, const std::vector<int>& assignments) {
     // Associer chaque centroid au label qui est le plus fréquent parmi les images du cluster
-    std::unordered_map<int, std::unordered_map<int, int>> clusterLabelCount;
-    for (size_t i = 0; i < images.size(); ++i) {
-        int cluster = assignments[i];
-        int label = images[i].getLabel();
-        clusterLabelCount[cluster][label]++;
+    const size_t slot = representationIndex(data.getRepresentationId());
+    std::vector<std::map<int, int>>& clusterLabelCount = clusterLabelCountsByRepresentation[slot];
+    clusterLabelCount.assign(numClusters, std::map<int, int>());
+    for (size_t i = 0; i < data.rows(); ++i) {
+        clusterLabelCount[assignments[i]][data.label(i)]++;
     }
+    updateCentroidLabels(slot);
+}
 
+void KMeans::updateCentroidLabels(size_t representation) {
+    const std::vector<std::map<int, int>>& clusterLabelCount = clusterLabelCountsByRepresentation[representation];
     std::vector<int> labels(numClusters, -1);
     for (int i = 0; i < numClusters; ++i) {
         int bestLabel = -1;
@@ -99,26 +735,173 @@ void KMeans::associateLabelsToCentroids(const std::vector<Image>& images, const
             }
         }
         labels[i] = bestLabel;
-        //std::cout << "Cluster " << i << " is associated with label " << bestLabel << " with " << maxCount << " images." << std::endl;
     }
 
-    centroidLabelsByRepresentation[images[0].getRepresentationType()] = labels;
+    centroidLabelsByRepresentation[representation] = labels;
+}
+
+bool KMeans::partialFit(const FeatureMatrix& batch, double* drift) {
+    if (drift) {
+        *drift = 0.0;
+    }
+    if (batch.empty()) {
+        return true;
+    }
+    if (batch.layout() != FeatureMatrix::Layout::RowMajor) {
+        return partialFit(batch.toLayout(FeatureMatrix::Layout::RowMajor), drift);
+    }
+
+    const size_t slot = representationIndex(batch.getRepresentationId());
+    const size_t dimension = batch.dimension();
+    ThreadPool& pool = ThreadPool::select(threadsFor(batch.rows(), options.numThreads), ownPool);
+    FeatureMatrix& centroids = centroidsByRepresentation[slot];
+    if (centroids.empty()) {
+        if (batch.rows() < static_cast<size_t>(numClusters)) {
+            std::cerr << "Erreur : Le premier lot de KMeans doit contenir au moins " << numClusters
+                      << " lignes (" << batch.rows() << " reçues)." << std::endl;
+            return false;
+        }
+        centroids = seedCentroids(batch, options.seed, pool);
+        clusterWeightsByRepresentation[slot].assign(numClusters, 0.0);
+        clusterLabelCountsByRepresentation[slot].assign(numClusters, std::map<int, int>());
+        iterationsByRepresentation[slot] = 0;
+        inertiaByRepresentation[slot] = 0.0;
+        distanceEvaluationsByRepresentation[slot] = 0;
+        restartsByRepresentation[slot].clear();
+        bestRestartByRepresentation[slot] = 0;
+    } else if (centroids.dimension() != dimension) {
+        std::cerr << "Erreur : Lot de dimension " << dimension << " pour des centroids de dimension "
+                  << centroids.dimension() << "." << std::endl;
+        return false;
+    }
+
+    // Assignation aux centroids d'avant le lot (même règle que Lloyd).
+    const DistanceKernels::Kernel squaredDistance = DistanceKernels::squaredEuclideanKernel(dimension);
+    std::vector<int> assignments(batch.rows(), -1);
+    assignLloyd(batch, centroids, assignments, squaredDistance, pool);
+    distanceEvaluationsByRepresentation[slot] += batch.rows() * static_cast<size_t>(numClusters);
+
+    const FeatureMatrix before = centroids;
+    std::vector<double>& weights = clusterWeightsByRepresentation[slot];
+    std::vector<std::map<int, int>>& labelCounts = clusterLabelCountsByRepresentation[slot];
+    for (size_t i = 0; i < batch.rows(); ++i) {
+        const int cluster = assignments[i];
+        const double* features = batch.row(i);
+        double* centroid = centroids.mutableRow(cluster);
+        weights[cluster] += 1.0;
+        const double rate = 1.0 / weights[cluster];
+        for (size_t j = 0; j < dimension; ++j) {
+            centroid[j] += rate * (features[j] - centroid[j]);
+        }
+        labelCounts[cluster][batch.label(i)]++;
+    }
+    updateCentroidLabels(slot);
+
+    if (drift) {
+        for (int c = 0; c < numClusters; ++c) {
+            *drift = std::max(*drift, std::sqrt(squaredDistance(before.row(c), centroids.row(c), dimension)));
+        }
+    }
+    return true;
+}
+
+bool KMeans::fitStream(const std::string& path, size_t batchSize) {
+    DescriptorBatchReader reader(options.numThreads);
+    if (!reader.open(path)) {
+        std::cerr << "Erreur : Impossible de lire les descripteurs de " << path << std::endl;
+        return false;
+    }
+    const size_t slot = representationIndex(reader.getRepresentationId());
+    const size_t dimension = representationDimension(reader.getRepresentationId());
+    if (dimension != static_cast<size_t>(numFeatures)) {
+        std::cerr << "Avertissement : KMeans configuré pour " << numFeatures << " descripteurs, "
+                  << dimension << " trouvés pour " << representationName(reader.getRepresentationId()) << "." << std::endl;
+    }
+    centroidsByRepresentation[slot] = FeatureMatrix();
+    centroidLabelsByRepresentation[slot].clear();
+
+    const DistanceKernels::Kernel squaredDistance = DistanceKernels::squaredEuclideanKernel(dimension);
+    FeatureMatrix batch;
+    int passes = 0;
+    bool converged = false;
+    while (passes < maxIterations && !converged) {
+        // Le déplacement d'une passe est mesuré entre les centroids du début et de la fin de la passe.
+        const FeatureMatrix start = centroidsByRepresentation[slot];
+        reader.rewind();
+        bool updated = false;
+        while (reader.next(batch, batchSize)) {
+            if (!partialFit(batch)) {
+                return false;
+            }
+            updated = true;
+        }
+        if (!updated) {
+            break;
+        }
+        ++passes;
+
+        const FeatureMatrix& centroids = centroidsByRepresentation[slot];
+        double drift = start.empty() ? std::numeric_limits<double>::infinity() : 0.0;
+        for (size_t c = 0; c < start.rows(); ++c) {
+            drift = std::max(drift, std::sqrt(squaredDistance(start.row(c), centroids.row(c), dimension)));
+        }
+        converged = drift < tolerance;
+    }
+
+    // Les centroids changent après chaque lot : l'inertie est recalculée sur une dernière passe,
+    // avec les centroids finaux (comme pour `fit`).
+    double inertia = 0.0;
+    if (passes > 0) {
+        const FeatureMatrix& centroids = centroidsByRepresentation[slot];
+        reader.rewind();
+        while (reader.next(batch, batchSize)) {
+            for (size_t i = 0; i < batch.rows(); ++i) {
+                double closest = std::numeric_limits<double>::max();
+                for (int c = 0; c < numClusters; ++c) {
+                    closest = std::min(closest, squaredDistance(batch.row(i), centroids.row(c), dimension));
+                }
+                inertia += closest;
+            }
+        }
+    }
+
+    iterationsByRepresentation[slot] = passes;
+    inertiaByRepresentation[slot] = inertia;
+    KMeansRestart summary;
+    summary.seed = options.seed;
+    summary.iterations = passes;
+    summary.inertia = inertia;
+    summary.distanceEvaluations = distanceEvaluationsByRepresentation[slot];
+    restartsByRepresentation[slot].assign(1, summary);
+    return passes > 0;
 }
 
 std::pair<int, double> KMeans::predictLabelWithConfidence(const Image& image) const {
-    const std::string& representation = image.getRepresentationType();
-    auto it = centroidsByRepresentation.find(representation);
-    if (it == centroidsByRepresentation.end()) {
+    const auto& features = image.getDescripteurs();
+    return predictLabelWithConfidence(features.data(), features.size(), image.getRepresentationId());
+}
+
+std::pair<int, double> KMeans::predictLabelWithConfidence(const double* features, size_t size,
+                                                          RepresentationId representationId) const {
+    const size_t representation = representationIndex(representationId);
+    const FeatureMatrix& centroids = centroidsByRepresentation[representation];
+    if (centroids.empty()) {
         std::cerr << "Erreur : Représentation non trouvée pour la prédiction." << std::endl;
         return {-1, 0.0};
     }
 
-    const auto& centroids = it->second;
-    const auto& features = image.getDescripteurs();
+    if (size != centroids.dimension()) {
+        std::cerr << "Erreur : Taille des descripteurs incompatible avec les centroids." << std::endl;
+        return {-1, 0.0};
+    }
+
     double minDistance = std::numeric_limits<double>::max();
     int closestCluster = -1;
+    const std::vector<int>& labels = centroidLabelsByRepresentation[representation];
     for (int i = 0; i < numClusters; ++i) {
-        double distance = calculateDistance(features, centroids[i]);
+        // Un cluster resté vide n'a pas de label : il ne peut pas être prédit.
+        if (labels[i] == -1) continue;
+        double distance = calculateDistance(features, centroids.row(i), size);
         if (distance < minDistance) {
             minDistance = distance;
             closestCluster = i;
@@ -126,32 +909,51 @@ std::pair<int, double> KMeans::predictLabelWithConfidence(const Image& image) co
     }
 
     // Utiliser l'association du label avec le centroid
-    auto labelIt = centroidLabelsByRepresentation.find(representation);
-    int label = -1;
-    if (labelIt != centroidLabelsByRepresentation.end()) {
-        label = labelIt->second[closestCluster];
+    if (closestCluster < 0) {
+        return {-1, 0.0};
     }
+    int label = labels[closestCluster];
 
-    double confidence = calculateConfidence(features, closestCluster);
+    double confidence = calculateConfidence(features, centroids, closestCluster);
     //std::cout << "Predicted label: " << label << " with confidence: " << confidence << std::endl;
     return {label, confidence};
 }
 
-double KMeans::calculateDistance(const std::vector<double>& a, const std::vector<double>& b) const {
-    double sum = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        double diff = a[i] - b[i];
-        sum += diff * diff;
-    }
-    return std::sqrt(sum);
+const FeatureMatrix& KMeans::getCentroids(RepresentationId representation) const {
+    return centroidsByRepresentation[representationIndex(representation)];
+}
+
+int KMeans::getIterations(RepresentationId representation) const {
+    return iterationsByRepresentation[representationIndex(representation)];
+}
+
+double KMeans::getInertia(RepresentationId representation) const {
+    return inertiaByRepresentation[representationIndex(representation)];
+}
+
+size_t KMeans::getDistanceEvaluations(RepresentationId representation) const {
+    return distanceEvaluationsByRepresentation[representationIndex(representation)];
+}
+
+const std::vector<KMeansRestart>& KMeans::getRestarts(RepresentationId representation) const {
+    return restartsByRepresentation[representationIndex(representation)];
+}
+
+size_t KMeans::getBestRestart(RepresentationId representation) const {
+    return bestRestartByRepresentation[representationIndex(representation)];
+}
+
+double KMeans::calculateDistance(const double* a, const double* b, size_t size) const {
+    return std::sqrt(DistanceKernels::squaredEuclideanKernel(size)(a, b, size));
 }
 
-double KMeans::calculateConfidence(const std::vector<double>& features, int closestCluster) const {
-    double distanceToClosest = calculateDistance(features, centroidsByRepresentation.begin()->second[closestCluster]);
+double KMeans::calculateConfidence(const double* features, const FeatureMatrix& centroids, int closestCluster) const {
+    const size_t size = centroids.dimension();
+    double distanceToClosest = calculateDistance(features, centroids.row(closestCluster), size);
     double totalDistance = 0.0;
 
-    for (const auto& centroid : centroidsByRepresentation.begin()->second) {
-        totalDistance += calculateDistance(features, centroid);
+    for (size_t i = 0; i < centroids.rows(); ++i) {
+        totalDistance += calculateDistance(features, centroids.row(i), size);
     }
 
     return 1.0 - (distanceToClosest / totalDistance);
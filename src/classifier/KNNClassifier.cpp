@@ -1,25 +1,241 @@
 #include "classifier/KNNClassifier.h"
+#include "classifier/TopKSelector.h"
+#include "classifier/KDTreeIndex.h"
+#include "dataRepo/DataCollection.h"
+#include "parallel/ThreadPool.h"
 #include <cmath>
 #include <algorithm>
 #include <unordered_map>
 #include <iostream>
 #include <cfloat>
+#include <limits>
+#include <stdexcept>
 
 using namespace std;
 
-unordered_map<string, unordered_map<int, vector<pair<string, double>>>> distancesByRepresentationAndLabel;
+namespace {
+    // Taille visée d'une tuile de panneaux d'entraînement (tient dans le cache L2).
+    const size_t kTileBytes = 256 * 1024;
+    // Nombre de requêtes traitées contre un panneau avant de passer au suivant.
+    const size_t kQueryBlock = 64;
+
+    /**
+     * Garde, pour une requête, tous les candidats dont la distance approchée peut encore être
+     * parmi les K meilleures compte tenu de l'erreur d'arrondi `margin` :
+     * approx <= (K-ième plus petite distance approchée) + 2 * margin.
+     */
+    class CandidateScreen {
+    public:
+        void reset(size_t kValue, double marginValue) {
+            k = kValue;
+            margin = marginValue;
+            bound = (k == 0) ? -numeric_limits<double>::infinity() : numeric_limits<double>::infinity();
+            limit = 2 * max<size_t>(k, 16);
+            buffer.clear();
+        }
+
+        void push(double approx, size_t index) {
+            if (approx > bound) {
+                return;
+            }
+            buffer.emplace_back(approx, index);
+            if (buffer.size() >= limit) {
+                prune();
+            }
+        }
+
+        const vector<pair<double, size_t>>& finish() {
+            prune();
+            return buffer;
+        }
 
-KNNClassifier::KNNClassifier(const vector<Image>& data, int kValue, const string& distType)
-    : dataset(data), k(kValue), distanceType(distType) {
+    private:
+        size_t k = 0;
+        double margin = 0.0;
+        double bound = 0.0;
+        size_t limit = 0;
+        vector<pair<double, size_t>> buffer;
+
+        void prune() {
+            if (buffer.size() > k && k > 0) {
+                nth_element(buffer.begin(), buffer.begin() + (k - 1), buffer.end());
+                bound = buffer[k - 1].first + 2 * margin;
+                buffer.erase(remove_if(buffer.begin(), buffer.end(),
+                                       [this](const pair<double, size_t>& c) { return c.first > bound; }),
+                             buffer.end());
+            }
+            // Beaucoup d'ex aequo : on agrandit le tampon plutôt que d'élaguer sans effet.
+            if (2 * buffer.size() > limit) {
+                limit *= 2;
+            }
+        }
+    };
+
+    /**
+     * Décompte des voix de voisins proposés par distance croissante. À égalité de voix, le label
+     * dont le premier voisin est le plus proche l'emporte. Les résultats intermédiaires donnent
+     * le vote pour chaque K sans recompter.
+     */
+    class VoteCounter {
+    public:
+        void reset() {
+            votes.clear();
+            best = 0;
+        }
+
+        void add(int label) {
+            // Labels rangés par première apparition : à égalité, le plus petit index gagne.
+            size_t i = 0;
+            while (i < votes.size() && votes[i].first != label) {
+                ++i;
+            }
+            if (i == votes.size()) {
+                votes.emplace_back(label, 0);
+            }
+            ++votes[i].second;
+            if (votes[i].second > votes[best].second || (votes[i].second == votes[best].second && i < best)) {
+                best = i;
+            }
+        }
+
+        int label() const { return votes.empty() ? -1 : votes[best].first; }
+        int count() const { return votes.empty() ? 0 : votes[best].second; }
+
+    private:
+        vector<pair<int, int>> votes; // (label, voix)
+        size_t best = 0;
+    };
+
+    // Contexte des requêtes sans contexte explicite : un par thread, réutilisé d'une requête à l'autre.
+    QueryContext& threadContext() {
+        thread_local QueryContext context;
+        return context;
+    }
+
+    FeatureMatrix selectRows(const FeatureMatrix& matrix, const vector<size_t>& indices) {
+        FeatureMatrix subset(indices.size(), matrix.dimension(), matrix.getRepresentationId());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            const double* values = matrix.row(indices[i]);
+            copy(values, values + matrix.dimension(), subset.mutableRow(i));
+            subset.setLabel(i, matrix.label(indices[i]));
+            subset.setPath(i, matrix.path(indices[i]));
+        }
+        return subset;
+    }
+
+    double squaredNorm(const double* values, size_t dimension) {
+        double sum = 0.0;
+        for (size_t d = 0; d < dimension; ++d) {
+            sum += values[d] * values[d];
+        }
+        return sum;
+    }
+}
+
+KNNClassifier::KNNClassifier(const vector<Image>& data, int kValue, const string& distType, const KNNIndexOptions& options)
+    : k(kValue), indexOptions(options) {
+    DistanceMetric metric = distanceMetricFromName(distType);
     if (!data.empty()) {
-        string expectedType = data[0].getRepresentationType();
+        RepresentationId expectedType = data[0].getRepresentationId();
         for (const auto& img : data) {
-            if (img.getRepresentationType() != expectedType) {
+            if (img.getRepresentationId() != expectedType) {
                 cerr << "Erreur : Les données fournies à KNNClassifier contiennent des représentations différentes." << endl;
                 throw runtime_error("Données non homogènes pour KNNClassifier.");
             }
         }
     }
+    dataset = DataCollection::buildFeatureMatrix(data);
+    distancePolicy = DistancePolicy(metric, dataset.dimension());
+    computeLabelRange();
+    buildIndex();
+}
+
+KNNClassifier::KNNClassifier(FeatureMatrix data, int kValue, const string& distType, const KNNIndexOptions& options)
+    : dataset(std::move(data)), k(kValue), indexOptions(options) {
+    DistanceMetric metric = distanceMetricFromName(distType);
+    if (dataset.layout() != FeatureMatrix::Layout::RowMajor) {
+        dataset = dataset.toLayout(FeatureMatrix::Layout::RowMajor);
+    }
+    distancePolicy = DistancePolicy(metric, dataset.dimension());
+    computeLabelRange();
+    buildIndex();
+}
+
+void KNNClassifier::computeLabelRange() {
+    labelBase = 0;
+    labelCount = 0;
+    if (dataset.empty()) {
+        return;
+    }
+    int low = dataset.label(0);
+    int high = low;
+    for (size_t i = 1; i < dataset.rows(); ++i) {
+        low = min(low, dataset.label(i));
+        high = max(high, dataset.label(i));
+    }
+    labelBase = low;
+    labelCount = static_cast<size_t>(static_cast<long long>(high) - low) + 1;
+}
+
+void KNNClassifier::buildIndex() {
+    index.reset();
+    KNNIndexOptions::Backend backend = indexOptions.backend;
+    if (backend == KNNIndexOptions::Backend::Auto) {
+        backend = (dataset.dimension() <= indexOptions.kdTreeMaxDimension) ? KNNIndexOptions::Backend::KDTree
+                                                                            : KNNIndexOptions::Backend::BruteForce;
+    }
+
+    if (!dataset.empty()) {
+        if (backend == KNNIndexOptions::Backend::KDTree) {
+            index = make_shared<KDTreeIndex>(dataset, distancePolicy, indexOptions.kdTreeLeafSize);
+        } else if (backend == KNNIndexOptions::Backend::HNSW) {
+            index = make_shared<HNSWIndex>(dataset, distancePolicy, indexOptions.hnsw);
+        } else if (backend == KNNIndexOptions::Backend::PQ) {
+            index = make_shared<PQIndex>(sharedDataset(), distancePolicy, indexOptions.pq);
+        } else if (backend == KNNIndexOptions::Backend::IVF) {
+            index = make_shared<IVFIndex>(dataset, distancePolicy, indexOptions.ivf);
+        } else if (backend == KNNIndexOptions::Backend::PrunedScan) {
+            index = make_shared<PrunedScanIndex>(sharedDataset(), distancePolicy, indexOptions.prunedScan);
+        }
+    }
+    buildBatchPanels();
+}
+
+FeatureMatrix KNNClassifier::sharedDataset() {
+    // Une tranche complète partage le buffer : copier la vue ne copie pas les descripteurs.
+    if (!dataset.isView()) {
+        dataset = dataset.slice(0, dataset.rows());
+    }
+    return dataset;
+}
+
+const char* KNNClassifier::indexName() const {
+    return index ? index->name() : "force brute";
+}
+
+void KNNClassifier::buildBatchPanels() {
+    trainPanels.clear();
+    trainSquaredNorms.clear();
+    maxTrainSquaredNorm = 0.0;
+    if (distancePolicy.metric() != DistanceMetric::Euclidean || index) {
+        return;
+    }
+
+    const size_t width = DistanceKernels::kPanelWidth;
+    const size_t dimension = dataset.dimension();
+    const size_t numPanels = (dataset.rows() + width - 1) / width;
+    trainPanels.assign(numPanels * dimension * width, 0.0);
+    trainSquaredNorms.resize(dataset.rows());
+
+    for (size_t i = 0; i < dataset.rows(); ++i) {
+        const double* values = dataset.row(i);
+        double* panel = trainPanels.data() + (i / width) * dimension * width;
+        for (size_t d = 0; d < dimension; ++d) {
+            panel[d * width + i % width] = values[d];
+        }
+        trainSquaredNorms[i] = squaredNorm(values, dimension);
+        maxTrainSquaredNorm = max(maxTrainSquaredNorm, trainSquaredNorms[i]);
+    }
 }
 
 double KNNClassifier::calculateDistance(const Image& img1, const Image& img2) const {
@@ -31,60 +247,72 @@ double KNNClassifier::calculateDistance(const Image& img1, const Image& img2) co
         return DBL_MAX; 
     }
 
-    double distance = 0.0;
+    return calculateDistance(descriptors1.data(), descriptors2.data(), descriptors1.size());
+}
 
-    if (distanceType == "euclidean") {
-        for (size_t i = 0; i < descriptors1.size(); ++i) {
-            distance += pow(descriptors1[i] - descriptors2[i], 2);
-        }
-        return sqrt(distance);
-    } else if (distanceType == "manhattan") {
-        for (size_t i = 0; i < descriptors1.size(); ++i) {
-            distance += abs(descriptors1[i] - descriptors2[i]);
-        }
-        return distance;
-    } else {
-        cerr << "Type de distance non reconnu : " << distanceType << endl;
-        throw invalid_argument("Type de distance non reconnu");
-    }
+double KNNClassifier::calculateDistance(const double* a, const double* b, size_t size) const {
+    return distancePolicy.distance(a, b, size);
 }
 
 vector<pair<double, int>> KNNClassifier::findKNearestNeighbors(const Image& queryImage) const {
-    vector<pair<double, int>> distances;
+    QueryContext& context = threadContext();
+    searchImage(queryImage, context);
+    return context.found;
+}
 
-    for (const auto& img : dataset) {
-        double dist = calculateDistance(queryImage, img);
-        distances.push_back(make_pair(dist, img.getLabel()));
+const vector<pair<double, int>>& KNNClassifier::findKNearestNeighbors(const double* query, QueryContext& context) const {
+    context.selector.reset(k > 0 ? static_cast<size_t>(k) : 0);
+    searchRow(query, context.selector);
+    context.selector.finish(context.found);
+    for (auto& neighbor : context.found) {
+        if (neighbor.first != DBL_MAX) {
+            neighbor.first = distancePolicy.finalize(neighbor.first);
+        }
     }
-
-    sort(distances.begin(), distances.end());
-
-    return vector<pair<double, int>>(distances.begin(), min(distances.begin() + k, distances.end()));
+    return context.found;
 }
 
-int KNNClassifier::predictLabel(const Image& queryImage) const {
-    vector<pair<double, int>> neighbors = findKNearestNeighbors(queryImage);
+void KNNClassifier::searchImage(const Image& queryImage, QueryContext& context) const {
+    const vector<double>& query = queryImage.getDescripteurs();
+    if (query.size() == dataset.dimension()) {
+        findKNearestNeighbors(query.data(), context);
+        return;
+    }
 
-    unordered_map<int, int> labelVotes;
+    cerr << "Erreur : Taille des descripteurs différente entre deux images." << endl;
+    context.selector.reset(k > 0 ? static_cast<size_t>(k) : 0);
+    for (size_t i = 0; i < dataset.rows(); ++i) {
+        context.selector.push(DBL_MAX, dataset.label(i));
+    }
+    context.selector.finish(context.found);
+}
 
-    for (const auto& neighbor : neighbors) {
-        labelVotes[neighbor.second]++;
+void KNNClassifier::searchRow(const double* query, TopKSelector& selector) const {
+    if (index) {
+        index->search(query, selector);
+        return;
     }
 
-    int predictedLabel = -1;
-    int maxVotes = 0;
-    for (const auto& vote : labelVotes) {
-        if (vote.second > maxVotes) {
-            predictedLabel = vote.first;
-            maxVotes = vote.second;
+    DistanceKernels::Kernel kernel = distancePolicy.rankKernel();
+    const size_t dimension = dataset.dimension();
+    for (size_t i = 0; i < dataset.rows(); ++i) {
+        double dist = kernel(query, dataset.row(i), dimension);
+        if (dist <= selector.threshold()) {
+            selector.push(dist, dataset.label(i));
         }
     }
+}
+
+int KNNClassifier::predictLabel(const Image& queryImage) const {
+    return predictLabelWithConfidence(queryImage).first;
+}
 
-    double confidence = static_cast<double>(maxVotes) / k;
-    cout << "Prédiction finale : " << predictedLabel
-         << ", Confiance : " << confidence * 100 << "%" << endl;
+pair<int, double> KNNClassifier::voteLabel(const vector<pair<double, int>>& neighbors, QueryContext& context) const {
+    pair<int, int> winner = context.vote(neighbors, labelBase, labelCount);
 
-    return predictedLabel;
+    double confidence = static_cast<double>(winner.second) / k;
+
+    return make_pair(winner.first, confidence);
 }
 
 
@@ -100,8 +328,8 @@ void KNNClassifier::printDatasetInfo() const {
     }
 
     cout << "=== Informations sur le dataset ===" << endl;
-    cout << "Taille du dataset : " << dataset.size() << endl;
-    cout << "Type de représentation : " << dataset[0].getRepresentationType() << endl;
+    cout << "Taille du dataset : " << dataset.rows() << endl;
+    cout << "Type de représentation : " << dataset.getRepresentationType() << endl;
     cout << "====================================" << endl;
 }
 
@@ -118,68 +346,182 @@ void KNNClassifier::checkClassBalance(const std::vector<Image>& data) {
     cout << "==============================================" << endl;
 }
 
-void KNNClassifier::calculateAndStoreDistances() {
-    distancesByRepresentationAndLabel.clear();
+KNNGraph KNNClassifier::buildNeighborGraph(size_t kNeighbors, size_t numThreads) const {
+    return KNNGraph::build(dataset, distancePolicy, kNeighbors, numThreads);
+}
 
-    unordered_map<int, vector<Image>> labelToImages;
-    for (const auto& img : dataset) {
-        labelToImages[img.getLabel()].push_back(img);
-    }
+std::pair<int, double> KNNClassifier::predictLabelWithConfidence(const Image& queryImage) const {
+    QueryContext& context = threadContext();
+    searchImage(queryImage, context);
+    return voteLabel(context.found, context);
+}
 
-    for (auto& entry : labelToImages) {
-        int label = entry.first;
-        vector<Image>& imagesWithLabel = entry.second;
+pair<int, double> KNNClassifier::predictLabelWithConfidence(const double* query, QueryContext& context) const {
+    return voteLabel(findKNearestNeighbors(query, context), context);
+}
 
-        if (imagesWithLabel.empty()) continue;
-        sort(imagesWithLabel.begin(), imagesWithLabel.end(), [](const Image& a, const Image& b) {
-            return a.getImagePath() < b.getImagePath();
-        });
-        const Image& referenceImage = imagesWithLabel[0];
+vector<vector<pair<double, int>>> KNNClassifier::findKNearestNeighborsBatch(const FeatureMatrix& queries) const {
+    vector<vector<pair<double, int>>> results(queries.rows());
+    const size_t dimension = dataset.dimension();
 
-        string representationType = referenceImage.getRepresentationType();
-        for (const auto& img : imagesWithLabel) {
-            double distance = calculateDistance(referenceImage, img);
-            distancesByRepresentationAndLabel[representationType][label].emplace_back(img.getImagePath(), distance);
+    // Lignes non contiguës ou de mauvaise dimension : chemin `Image` (qui signale l'erreur de taille).
+    if (queries.dimension() != dimension || queries.layout() != FeatureMatrix::Layout::RowMajor) {
+        for (size_t q = 0; q < queries.rows(); ++q) {
+            results[q] = findKNearestNeighbors(queries.toImage(q));
         }
+        return results;
     }
-}
 
-void KNNClassifier::printStoredDistances() const {
-    for (const auto& representationEntry : distancesByRepresentationAndLabel) {
-        const string& representation = representationEntry.first;
-        cout << "\n=== Distances pour la représentation : " << representation << " ===" << endl;
+    // Avec un index, ou hors du cas euclidien, recherche requête par requête sur les lignes de la matrice.
+    if (index || distancePolicy.metric() != DistanceMetric::Euclidean || dataset.empty()) {
+        QueryContext context;
+        for (size_t q = 0; q < queries.rows(); ++q) {
+            results[q] = findKNearestNeighbors(queries.row(q), context);
+        }
+        return results;
+    }
 
-        for (const auto& labelEntry : representationEntry.second) {
-            int label = labelEntry.first;
-            const auto& distances = labelEntry.second;
+    const size_t width = DistanceKernels::kPanelWidth;
+    const size_t numPanels = (dataset.rows() + width - 1) / width;
+    const size_t panelSize = dimension * width;
+    const size_t panelsPerTile = max<size_t>(1, kTileBytes / (panelSize * sizeof(double)));
+    const size_t kValue = k > 0 ? static_cast<size_t>(k) : 0;
+    DistanceKernels::DotPanelKernel dotPanel = DistanceKernels::dotPanelKernel();
+
+    // Borne de l'écart entre ||q||² + ||t||² - 2 q.t et le noyau exact (erreurs d'arrondi des deux calculs).
+    vector<double> querySquaredNorms(queries.rows());
+    vector<CandidateScreen> screens(queries.rows());
+    for (size_t q = 0; q < queries.rows(); ++q) {
+        querySquaredNorms[q] = squaredNorm(queries.row(q), dimension);
+        double margin = 8.0 * (dimension + 4) * DBL_EPSILON * (querySquaredNorms[q] + maxTrainSquaredNorm);
+        screens[q].reset(kValue, margin);
+    }
 
-            cout << "Classe " << label << ": [ ";
-            for (const auto& distPair : distances) {
-                cout << distPair.second << " "; 
+    vector<double> dots(kQueryBlock * width);
+    for (size_t tileBegin = 0; tileBegin < numPanels; tileBegin += panelsPerTile) {
+        const size_t tileEnd = min(numPanels, tileBegin + panelsPerTile);
+        for (size_t queryBegin = 0; queryBegin < queries.rows(); queryBegin += kQueryBlock) {
+            const size_t blockRows = min(kQueryBlock, queries.rows() - queryBegin);
+            for (size_t p = tileBegin; p < tileEnd; ++p) {
+                dotPanel(queries.row(queryBegin), queries.stride(), blockRows,
+                         trainPanels.data() + p * panelSize, dimension, dots.data(), width);
+
+                const size_t rowBegin = p * width;
+                const size_t rowCount = min(width, dataset.rows() - rowBegin);
+                for (size_t r = 0; r < blockRows; ++r) {
+                    const double queryNorm = querySquaredNorms[queryBegin + r];
+                    CandidateScreen& screen = screens[queryBegin + r];
+                    for (size_t j = 0; j < rowCount; ++j) {
+                        double approx = queryNorm + trainSquaredNorms[rowBegin + j] - 2.0 * dots[r * width + j];
+                        screen.push(approx, rowBegin + j);
+                    }
+                }
             }
-            cout << "]" << endl;
         }
     }
+
+    // Reclassement exact des candidats retenus.
+    TopKSelector selector;
+    for (size_t q = 0; q < queries.rows(); ++q) {
+        selector.reset(kValue);
+        const double* query = queries.row(q);
+        for (const auto& candidate : screens[q].finish()) {
+            selector.push(distancePolicy.rank(query, dataset.row(candidate.second)), dataset.label(candidate.second));
+        }
+        selector.finish(results[q]);
+        for (auto& neighbor : results[q]) {
+            neighbor.first = distancePolicy.finalize(neighbor.first);
+        }
+    }
+    return results;
 }
 
-std::pair<int, double> KNNClassifier::predictLabelWithConfidence(const Image& queryImage) const {
-    std::vector<std::pair<double, int>> neighbors = findKNearestNeighbors(queryImage);
+vector<pair<int, double>> KNNClassifier::predictBatch(const FeatureMatrix& queries) const {
+    vector<vector<pair<double, int>>> neighbors = findKNearestNeighborsBatch(queries);
+    vector<pair<int, double>> predictions;
+    predictions.reserve(neighbors.size());
+    QueryContext context;
+    for (const auto& queryNeighbors : neighbors) {
+        predictions.push_back(voteLabel(queryNeighbors, context));
+    }
+    return predictions;
+}
+
+vector<pair<int, double>> KNNClassifier::predictBatch(const vector<Image>& queries) const {
+    return predictBatch(DataCollection::buildFeatureMatrix(queries));
+}
 
-    std::unordered_map<int, int> labelVotes;
-    for (const auto& neighbor : neighbors) {
-        labelVotes[neighbor.second]++;
+int findOptimalKWithCrossValidation(const vector<Image>& data, const string& distanceType, int maxK, int numFolds,
+                                    vector<double>* accuracyByK) {
+    if (maxK < 1 || numFolds < 2) {
+        cerr << "Erreur : Validation croisée impossible avec maxK = " << maxK << " et " << numFolds << " plis." << endl;
+        throw invalid_argument("Paramètres de validation croisée invalides.");
+    }
+    if (data.empty()) {
+        cerr << "Erreur : Aucune donnée fournie pour la validation croisée." << endl;
+        return 1;
     }
 
-    int predictedLabel = -1;
-    int maxVotes = 0;
-    for (const auto& vote : labelVotes) {
-        if (vote.second > maxVotes) {
-            predictedLabel = vote.first;
-            maxVotes = vote.second;
-        }
+    FeatureMatrix all = DataCollection::buildFeatureMatrix(data);
+    const size_t folds = static_cast<size_t>(numFolds);
+    const size_t maxNeighbors = static_cast<size_t>(maxK);
+
+    // Plis stratifiés : les lignes de chaque label sont distribuées à tour de rôle.
+    vector<size_t> foldOfRow(all.rows());
+    unordered_map<int, size_t> rowsSeenByLabel;
+    for (size_t i = 0; i < all.rows(); ++i) {
+        foldOfRow[i] = rowsSeenByLabel[all.label(i)]++ % folds;
     }
 
-    double confidence = static_cast<double>(maxVotes) / k;
+    // Un seul passage de recherche par pli (K = maxK) ; chaque K est évalué sur le préfixe de
+    // ses K premiers voisins. Les plis sont traités en parallèle.
+    vector<vector<int>> correctByFold(folds, vector<int>(maxNeighbors + 1, 0));
+    ThreadPool::shared().parallelFor(folds, [&](size_t fold, size_t) {
+        vector<size_t> trainRows, testRows;
+        for (size_t i = 0; i < all.rows(); ++i) {
+            (foldOfRow[i] == fold ? testRows : trainRows).push_back(i);
+        }
+        if (trainRows.empty() || testRows.empty()) {
+            return;
+        }
 
-    return std::make_pair(predictedLabel, confidence);
+        KNNClassifier knn(selectRows(all, trainRows), maxK, distanceType);
+        FeatureMatrix test = selectRows(all, testRows);
+        vector<vector<pair<double, int>>> neighbors = knn.findKNearestNeighborsBatch(test);
+
+        VoteCounter counter;
+        vector<int>& correct = correctByFold[fold];
+        for (size_t q = 0; q < test.rows(); ++q) {
+            counter.reset();
+            for (size_t kValue = 1; kValue <= maxNeighbors; ++kValue) {
+                if (kValue <= neighbors[q].size()) {
+                    counter.add(neighbors[q][kValue - 1].second);
+                }
+                if (counter.label() == test.label(q)) {
+                    ++correct[kValue];
+                }
+            }
+        }
+    });
+
+    // K le plus précis ; à égalité, le plus petit.
+    int bestK = 1;
+    int bestCorrect = -1;
+    if (accuracyByK) {
+        accuracyByK->assign(maxNeighbors, 0.0);
+    }
+    for (size_t kValue = 1; kValue <= maxNeighbors; ++kValue) {
+        int correct = 0;
+        for (size_t fold = 0; fold < folds; ++fold) {
+            correct += correctByFold[fold][kValue];
+        }
+        if (accuracyByK) {
+            (*accuracyByK)[kValue - 1] = static_cast<double>(correct) / all.rows();
+        }
+        if (correct > bestCorrect) {
+            bestCorrect = correct;
+            bestK = static_cast<int>(kValue);
+        }
+    }
+    return bestK;
 }
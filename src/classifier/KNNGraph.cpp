@@ -0,0 +1,234 @@
+#include "classifier/KNNGraph.h"
+#include "classifier/TopKSelector.h"
+#include "dataRepo/RepresentationTraits.h"
+#include "parallel/ThreadPool.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    const char kMagic[8] = {'R', 'F', 'K', 'N', 'N', 'G', 'R', 'F'};
+    const uint32_t kByteOrderMark = 0x01020304;
+
+    // Taille visée pour un bloc de lignes : deux blocs d'une tuile tiennent dans le cache L2.
+    const size_t kBlockBytes = 64 * 1024;
+
+    struct Block {
+        size_t begin;
+        size_t end;
+    };
+
+    // Calcule la tuile (I, J) : chaque distance est proposée aux deux lignes concernées.
+    // Sur la diagonale (I == J), seules les paires a < b sont calculées.
+    void computeTile(const FeatureMatrix& data, DistanceKernels::Kernel kernel, const Block& first, const Block& second,
+                     vector<TopKSelector>& selectors) {
+        const size_t dimension = data.dimension();
+        const bool diagonal = first.begin == second.begin;
+        for (size_t a = first.begin; a < first.end; ++a) {
+            const double* rowA = data.row(a);
+            TopKSelector& selectorA = selectors[a];
+            for (size_t b = diagonal ? a + 1 : second.begin; b < second.end; ++b) {
+                double distance = kernel(rowA, data.row(b), dimension);
+                if (distance <= selectorA.threshold()) {
+                    selectorA.push(distance, static_cast<int>(b));
+                }
+                TopKSelector& selectorB = selectors[b];
+                if (distance <= selectorB.threshold()) {
+                    selectorB.push(distance, static_cast<int>(a));
+                }
+            }
+        }
+    }
+}
+
+KNNGraph::KNNGraph()
+    : distanceMetric(DistanceMetric::Euclidean), representation(RepresentationId::Unknown), kNeighbors(0), offsets(1, 0) {}
+
+KNNGraph KNNGraph::build(const FeatureMatrix& data, const DistancePolicy& policy, size_t k, size_t numThreads) {
+    if (data.layout() != FeatureMatrix::Layout::RowMajor) {
+        return build(data.toLayout(FeatureMatrix::Layout::RowMajor), policy, k, numThreads);
+    }
+    if (policy.dimension() != data.dimension()) {
+        throw invalid_argument("KNNGraph : la dimension de la distance ne correspond pas au dataset");
+    }
+    const size_t rows = data.rows();
+    if (rows > static_cast<size_t>(INT_MAX)) {
+        throw invalid_argument("KNNGraph : trop de lignes pour des index 32 bits");
+    }
+
+    KNNGraph graph;
+    graph.distanceMetric = policy.metric();
+    graph.representation = data.getRepresentationId();
+    graph.kNeighbors = rows > 0 ? min(k, rows - 1) : 0;
+    graph.labels.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        graph.labels[i] = data.label(i);
+    }
+    graph.offsets.assign(rows + 1, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        graph.offsets[i + 1] = graph.offsets[i] + graph.kNeighbors;
+    }
+    if (graph.kNeighbors == 0) {
+        return graph;
+    }
+
+    unique_ptr<ThreadPool> privatePool;
+    ThreadPool& pool = ThreadPool::select(numThreads, privatePool);
+
+    // Blocs assez petits pour le cache, et assez nombreux pour occuper tous les threads à chaque ronde.
+    size_t blockRows = max<size_t>(16, kBlockBytes / (data.stride() * sizeof(double)));
+    blockRows = max<size_t>(1, min(blockRows, (rows + 2 * pool.size() - 1) / (2 * pool.size())));
+    vector<Block> blocks;
+    for (size_t begin = 0; begin < rows; begin += blockRows) {
+        blocks.push_back(Block{begin, min(rows, begin + blockRows)});
+    }
+
+    vector<TopKSelector> selectors(rows);
+    for (TopKSelector& selector : selectors) {
+        selector.reset(graph.kNeighbors);
+    }
+    DistanceKernels::Kernel kernel = policy.rankKernel();
+
+    // Tuiles diagonales : chacune ne touche que son bloc.
+    pool.parallelFor(blocks.size(), [&](size_t b, size_t) {
+        computeTile(data, kernel, blocks[b], blocks[b], selectors);
+    });
+
+    // Méthode du cercle : avec m blocs (m pair, un bloc fictif si besoin), m - 1 rondes de m / 2
+    // paires disjointes couvrent chaque paire de blocs exactement une fois.
+    const size_t blockCount = blocks.size();
+    const size_t m = blockCount + (blockCount % 2);
+    vector<pair<size_t, size_t>> roundPairs;
+    for (size_t round = 0; round + 1 < m; ++round) {
+        roundPairs.clear();
+        for (size_t i = 0; i < m / 2; ++i) {
+            size_t first = i == 0 ? m - 1 : (round + i) % (m - 1);
+            size_t second = (round + m - 1 - i) % (m - 1);
+            if (first < blockCount && second < blockCount) {
+                roundPairs.emplace_back(min(first, second), max(first, second));
+            }
+        }
+        pool.parallelFor(roundPairs.size(), [&](size_t p, size_t) {
+            computeTile(data, kernel, blocks[roundPairs[p].first], blocks[roundPairs[p].second], selectors);
+        });
+    }
+
+    graph.targets.resize(rows * graph.kNeighbors);
+    graph.weights.resize(rows * graph.kNeighbors);
+    vector<vector<TopKSelector::Neighbor>> finished(pool.size());
+    pool.parallelFor(rows, [&](size_t i, size_t worker) {
+        vector<TopKSelector::Neighbor>& neighbors = finished[worker];
+        selectors[i].finish(neighbors);
+        const size_t offset = graph.offsets[i];
+        for (size_t j = 0; j < neighbors.size(); ++j) {
+            graph.targets[offset + j] = static_cast<uint32_t>(neighbors[j].second);
+            graph.weights[offset + j] = policy.finalize(neighbors[j].first);
+        }
+        selectors[i] = TopKSelector();
+    });
+    return graph;
+}
+
+size_t KNNGraph::memoryBytes() const {
+    return labels.size() * sizeof(int32_t) + offsets.size() * sizeof(uint64_t)
+        + targets.size() * sizeof(uint32_t) + weights.size() * sizeof(double);
+}
+
+bool KNNGraph::save(const string& filePath) const {
+    const string& representationType = representationName(representation);
+    Header header{};
+    if (representationType.size() >= sizeof(header.representation)) {
+        cerr << "Erreur : Nom de représentation trop long : " << representationType << endl;
+        return false;
+    }
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.metric = static_cast<uint32_t>(distanceMetric);
+    header.rows = labels.size();
+    header.k = kNeighbors;
+    header.edges = targets.size();
+    memcpy(header.representation, representationType.data(), representationType.size());
+
+    ofstream out(filePath, ios::binary | ios::trunc);
+    if (!out) {
+        cerr << "Erreur : Impossible de créer le fichier " << filePath << endl;
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(labels.data()), labels.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(targets.data()), targets.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(double));
+
+    if (!out.good()) {
+        cerr << "Erreur lors de l'écriture du fichier : " << filePath << endl;
+        return false;
+    }
+    return true;
+}
+
+bool KNNGraph::load(const string& filePath) {
+    ifstream in(filePath, ios::binary | ios::ate);
+    if (!in) {
+        cerr << "Erreur : Impossible d'ouvrir le fichier " << filePath << endl;
+        return false;
+    }
+    const uint64_t fileLength = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+
+    Header header;
+    bool valid = fileLength >= sizeof(Header) && in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.version == kVersion
+        && header.byteOrderMark == kByteOrderMark
+        && (header.metric == static_cast<uint32_t>(DistanceMetric::Euclidean)
+            || header.metric == static_cast<uint32_t>(DistanceMetric::Manhattan))
+        && header.representation[sizeof(header.representation) - 1] == '\0'
+        && header.rows <= static_cast<uint64_t>(INT_MAX)
+        && header.k <= header.rows
+        && header.edges <= header.rows * header.k
+        && fileLength == sizeof(Header) + header.rows * (sizeof(int32_t) + sizeof(uint64_t)) + sizeof(uint64_t)
+                         + header.edges * (sizeof(uint32_t) + sizeof(double));
+
+    vector<int32_t> fileLabels;
+    vector<uint64_t> fileOffsets;
+    vector<uint32_t> fileTargets;
+    vector<double> fileWeights;
+    if (valid) {
+        fileLabels.resize(header.rows);
+        fileOffsets.resize(header.rows + 1);
+        fileTargets.resize(header.edges);
+        fileWeights.resize(header.edges);
+        in.read(reinterpret_cast<char*>(fileLabels.data()), fileLabels.size() * sizeof(int32_t));
+        in.read(reinterpret_cast<char*>(fileOffsets.data()), fileOffsets.size() * sizeof(uint64_t));
+        in.read(reinterpret_cast<char*>(fileTargets.data()), fileTargets.size() * sizeof(uint32_t));
+        in.read(reinterpret_cast<char*>(fileWeights.data()), fileWeights.size() * sizeof(double));
+        valid = in.good() && fileOffsets[0] == 0 && fileOffsets[header.rows] == header.edges;
+    }
+    for (uint64_t i = 0; valid && i < header.rows; ++i) {
+        valid = fileOffsets[i] <= fileOffsets[i + 1];
+    }
+    for (uint64_t e = 0; valid && e < header.edges; ++e) {
+        valid = fileTargets[e] < header.rows;
+    }
+
+    if (!valid) {
+        cerr << "Erreur : Graphe invalide ou version non supportée : " << filePath << endl;
+        return false;
+    }
+
+    distanceMetric = static_cast<DistanceMetric>(header.metric);
+    representation = representationFromName(header.representation);
+    kNeighbors = header.k;
+    labels = move(fileLabels);
+    offsets = move(fileOffsets);
+    targets = move(fileTargets);
+    weights = move(fileWeights);
+    return true;
+}
@@ -0,0 +1,166 @@
+#include "classifier/PQIndex.h"
+#include "classifier/KMeans.h"
+#include "parallel/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+PQIndex::PQIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy, const PQParameters& options)
+    : policy(distancePolicy), parameters(options), vectors(data), numSubspaces(0), numCentroids(0) {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    if (rows == 0 || dimension == 0) {
+        return;
+    }
+
+    numSubspaces = parameters.subspaces ? min(parameters.subspaces, dimension) : max<size_t>(1, dimension / 4);
+    numCentroids = min(rows, min<size_t>(256, max<size_t>(1, parameters.centroids)));
+
+    subspaceBegin.resize(numSubspaces + 1);
+    codebookOffset.resize(numSubspaces + 1);
+    for (size_t j = 0; j <= numSubspaces; ++j) {
+        subspaceBegin[j] = j * dimension / numSubspaces;
+        codebookOffset[j] = numCentroids * subspaceBegin[j];
+    }
+    codebooks.assign(numCentroids * dimension, 0.0);
+
+    // Échantillon régulier des lignes pour l'apprentissage des dictionnaires.
+    vector<size_t> sample;
+    const size_t sampleSize = (parameters.trainingSample && parameters.trainingSample < rows) ? parameters.trainingSample : rows;
+    sample.reserve(sampleSize);
+    for (size_t s = 0; s < sampleSize; ++s) {
+        sample.push_back(s * rows / sampleSize);
+    }
+
+    unique_ptr<ThreadPool> privatePool;
+    ThreadPool& pool = ThreadPool::select(parameters.numThreads, privatePool);
+    pool.parallelFor(numSubspaces, [&](size_t j, size_t) {
+        const size_t begin = subspaceBegin[j];
+        const size_t size = subspaceBegin[j + 1] - begin;
+        FeatureMatrix block(sample.size(), size, data.getRepresentationId());
+        for (size_t s = 0; s < sample.size(); ++s) {
+            const double* values = data.row(sample[s]) + begin;
+            copy(values, values + size, block.mutableRow(s));
+            block.setLabel(s, data.label(sample[s]));
+        }
+
+        // Les sous-espaces sont déjà répartis sur le pool : chaque KMeans reste séquentiel.
+        KMeansOptions options;
+        options.numThreads = 1;
+        KMeans kmeans(static_cast<int>(numCentroids), static_cast<int>(size), parameters.trainIterations, 1e-4, options);
+        kmeans.fit(block);
+        const FeatureMatrix& centroids = kmeans.getCentroids(data.getRepresentationId());
+        for (size_t c = 0; c < numCentroids; ++c) {
+            copy(centroids.row(c), centroids.row(c) + size, codebooks.data() + codebookOffset[j] + c * size);
+        }
+    });
+
+    codes.resize(rows * numSubspaces);
+    pool.parallelFor(rows, [this](size_t i, size_t) {
+        encode(vectors.row(i), codes.data() + i * numSubspaces);
+    });
+}
+
+double PQIndex::subDistance(const double* a, const double* b, size_t size) const {
+    double sum = 0.0;
+    if (policy.metric() == DistanceMetric::Euclidean) {
+        for (size_t d = 0; d < size; ++d) {
+            double diff = a[d] - b[d];
+            sum += diff * diff;
+        }
+    } else {
+        for (size_t d = 0; d < size; ++d) {
+            sum += fabs(a[d] - b[d]);
+        }
+    }
+    return sum;
+}
+
+void PQIndex::encode(const double* values, uint8_t* code) const {
+    for (size_t j = 0; j < numSubspaces; ++j) {
+        const size_t begin = subspaceBegin[j];
+        const size_t size = subspaceBegin[j + 1] - begin;
+        const double* codebook = codebooks.data() + codebookOffset[j];
+        double best = numeric_limits<double>::infinity();
+        size_t closest = 0;
+        for (size_t c = 0; c < numCentroids; ++c) {
+            double distance = subDistance(values + begin, codebook + c * size, size);
+            if (distance < best) {
+                best = distance;
+                closest = c;
+            }
+        }
+        code[j] = static_cast<uint8_t>(closest);
+    }
+}
+
+size_t PQIndex::compressedBytes() const {
+    return codes.size() * sizeof(uint8_t) + codebooks.size() * sizeof(double);
+}
+
+void PQIndex::search(const double* query, TopKSelector& selector) const {
+    if (numSubspaces == 0 || selector.capacity() == 0) {
+        return;
+    }
+
+    // Tampons réutilisés d'une requête à l'autre (un par thread).
+    thread_local vector<float> table;
+    thread_local TopKSelector shortlist;
+    thread_local vector<TopKSelector::Neighbor> candidates;
+
+    // Table des distances de chaque bloc de la requête à chaque centroid de son sous-espace.
+    table.resize(numSubspaces * numCentroids);
+    for (size_t j = 0; j < numSubspaces; ++j) {
+        const size_t begin = subspaceBegin[j];
+        const size_t size = subspaceBegin[j + 1] - begin;
+        const double* codebook = codebooks.data() + codebookOffset[j];
+        for (size_t c = 0; c < numCentroids; ++c) {
+            table[j * numCentroids + c] = static_cast<float>(subDistance(query + begin, codebook + c * size, size));
+        }
+    }
+
+    // Parcours des codes, quatre lignes à la fois pour avoir quatre chaînes d'additions
+    // indépendantes. Le « label » du sélecteur est ici l'index de la ligne.
+    const size_t rows = vectors.rows();
+    const float* tableData = table.data();
+    shortlist.reset(min(rows, max<size_t>(1, parameters.rerankFactor) * selector.capacity()));
+    size_t i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        const uint8_t* code = codes.data() + i * numSubspaces;
+        float approx[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (size_t j = 0; j < numSubspaces; ++j) {
+            const float* subTable = tableData + j * numCentroids;
+            approx[0] += subTable[code[j]];
+            approx[1] += subTable[code[numSubspaces + j]];
+            approx[2] += subTable[code[2 * numSubspaces + j]];
+            approx[3] += subTable[code[3 * numSubspaces + j]];
+        }
+        for (size_t r = 0; r < 4; ++r) {
+            if (approx[r] <= shortlist.threshold()) {
+                shortlist.push(approx[r], static_cast<int>(i + r));
+            }
+        }
+    }
+    for (; i < rows; ++i) {
+        const uint8_t* code = codes.data() + i * numSubspaces;
+        float approx = 0.0f;
+        for (size_t j = 0; j < numSubspaces; ++j) {
+            approx += tableData[j * numCentroids + code[j]];
+        }
+        if (approx <= shortlist.threshold()) {
+            shortlist.push(approx, static_cast<int>(i));
+        }
+    }
+    shortlist.finish(candidates);
+
+    // Reclassement exact.
+    for (const auto& candidate : candidates) {
+        const size_t i = static_cast<size_t>(candidate.second);
+        double distance = policy.rank(query, vectors.row(i));
+        if (distance <= selector.threshold()) {
+            selector.push(distance, vectors.label(i));
+        }
+    }
+}
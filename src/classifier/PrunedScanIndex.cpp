@@ -0,0 +1,210 @@
+#include "classifier/PrunedScanIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+    // Marge relative avant de rejeter une ligne : une somme partielle dans un autre ordre que le
+    // noyau, ou une borne triangulaire sur des distances arrondies, peut dépasser de quelques ulps
+    // la vraie distance.
+    const double kPruneSlack = 1e-9;
+
+    const uint32_t kEmptySlot = numeric_limits<uint32_t>::max();
+}
+
+PrunedScanIndex::PrunedScanIndex(const FeatureMatrix& data, const DistancePolicy& distancePolicy,
+                                 const PrunedScanParameters& parameters)
+    : policy(distancePolicy),
+      panelKernel(distancePolicy.metric() == DistanceMetric::Euclidean ? DistanceKernels::squaredEuclideanPanelKernel()
+                                                                       : DistanceKernels::manhattanPanelKernel()),
+      vectors(data) {
+    const size_t rows = data.rows();
+    const size_t dimension = data.dimension();
+    const size_t width = DistanceKernels::kPanelWidth;
+
+    vector<double> mean(dimension, 0.0);
+    vector<double> variance(dimension, 0.0);
+    for (size_t i = 0; i < rows; ++i) {
+        const double* values = data.row(i);
+        for (size_t d = 0; d < dimension; ++d) {
+            mean[d] += values[d];
+        }
+    }
+    for (size_t d = 0; d < dimension && rows > 0; ++d) {
+        mean[d] /= static_cast<double>(rows);
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        const double* values = data.row(i);
+        for (size_t d = 0; d < dimension; ++d) {
+            variance[d] += (values[d] - mean[d]) * (values[d] - mean[d]);
+        }
+    }
+    dimensionOrder.resize(dimension);
+    iota(dimensionOrder.begin(), dimensionOrder.end(), 0);
+    stable_sort(dimensionOrder.begin(), dimensionOrder.end(),
+                [&variance](size_t a, size_t b) { return variance[a] > variance[b]; });
+
+    const size_t pivots = min(parameters.pivots, rows);
+    vector<double> pivotDistances = choosePivots(pivots);
+
+    // Lignes triées par distance au premier pivot : les panneaux voisins couvrent des intervalles voisins.
+    vector<uint32_t> order(rows);
+    iota(order.begin(), order.end(), 0);
+    if (pivots > 0) {
+        stable_sort(order.begin(), order.end(), [&pivotDistances, pivots](uint32_t a, uint32_t b) {
+            return pivotDistances[a * pivots] < pivotDistances[b * pivots];
+        });
+    }
+
+    // Places vides remplies d'infinis : leurs sommes dépassent toute borne finie.
+    const size_t numPanels = (rows + width - 1) / width;
+    panels.assign(numPanels * dimension * width, numeric_limits<double>::infinity());
+    panelRows.assign(numPanels * width, kEmptySlot);
+    pivotLow.assign(numPanels * pivots, numeric_limits<double>::infinity());
+    pivotHigh.assign(numPanels * pivots, 0.0);
+    for (size_t slot = 0; slot < rows; ++slot) {
+        const size_t row = order[slot];
+        const size_t panel = slot / width;
+        const double* values = data.row(row);
+        double* target = panels.data() + panel * dimension * width + slot % width;
+        for (size_t d = 0; d < dimension; ++d) {
+            target[d * width] = values[dimensionOrder[d]];
+        }
+        panelRows[slot] = static_cast<uint32_t>(row);
+        for (size_t p = 0; p < pivots; ++p) {
+            pivotLow[panel * pivots + p] = min(pivotLow[panel * pivots + p], pivotDistances[row * pivots + p]);
+            pivotHigh[panel * pivots + p] = max(pivotHigh[panel * pivots + p], pivotDistances[row * pivots + p]);
+        }
+    }
+}
+
+vector<double> PrunedScanIndex::choosePivots(size_t count) {
+    const size_t rows = vectors.rows();
+    vector<double> distances(rows * count, 0.0);
+    if (count == 0) {
+        return distances;
+    }
+
+    // Parcours du plus éloigné : le premier pivot est la ligne la plus loin de la ligne 0, chaque
+    // suivant la ligne la plus loin des pivots déjà choisis.
+    vector<double> nearestPivot(rows, numeric_limits<double>::infinity());
+    size_t next = 0;
+    double farthest = -1.0;
+    for (size_t i = 0; i < rows; ++i) {
+        double distance = policy.rank(vectors.row(0), vectors.row(i));
+        if (distance > farthest) {
+            farthest = distance;
+            next = i;
+        }
+    }
+    for (size_t p = 0; p < count; ++p) {
+        pivotRows.push_back(next);
+        const double* pivot = vectors.row(next);
+        farthest = -1.0;
+        for (size_t i = 0; i < rows; ++i) {
+            double distance = policy.finalize(policy.rank(pivot, vectors.row(i)));
+            distances[i * count + p] = distance;
+            nearestPivot[i] = min(nearestPivot[i], distance);
+            if (nearestPivot[i] > farthest) {
+                farthest = nearestPivot[i];
+                next = i;
+            }
+        }
+    }
+    return distances;
+}
+
+void PrunedScanIndex::search(const double* query, TopKSelector& selector) const {
+    // Requête réordonnée et distances aux pivots (un tampon par thread).
+    thread_local vector<double> reorderedQuery;
+    thread_local vector<double> queryPivots;
+    const size_t dimension = vectors.dimension();
+    const size_t width = DistanceKernels::kPanelWidth;
+    const size_t pivots = pivotRows.size();
+    reorderedQuery.resize(dimension);
+    for (size_t d = 0; d < dimension; ++d) {
+        reorderedQuery[d] = query[dimensionOrder[d]];
+    }
+    queryPivots.resize(pivots);
+    for (size_t p = 0; p < pivots; ++p) {
+        queryPivots[p] = policy.finalize(policy.rank(query, vectors.row(pivotRows[p])));
+    }
+
+    DistanceKernels::Kernel kernel = policy.rankKernel();
+    double threshold = -1.0;
+    double rankBound = numeric_limits<double>::infinity();
+    double trueBound = rankBound;
+    auto refreshBounds = [&]() {
+        if (selector.threshold() != threshold) {
+            threshold = selector.threshold();
+            rankBound = threshold + threshold * kPruneSlack;
+            trueBound = policy.finalize(rankBound);
+        }
+    };
+    // Écart minimal à un intervalle de distances au pivot, comparé à la borne avec une marge
+    // proportionnelle aux distances au pivot (leur arrondi ne dépend pas de la distance cherchée).
+    auto outOfReach = [&](double gap, double scale) {
+        return gap > trueBound + scale * kPruneSlack;
+    };
+
+    double partial[DistanceKernels::kPanelWidth];
+    auto scanPanel = [&](size_t panel) {
+        refreshBounds();
+        for (size_t p = 0; p < pivots; ++p) {
+            const double low = pivotLow[panel * pivots + p];
+            const double high = pivotHigh[panel * pivots + p];
+            if (outOfReach(max(queryPivots[p] - high, low - queryPivots[p]), queryPivots[p] + high)) {
+                return;
+            }
+        }
+        panelKernel(reorderedQuery.data(), panels.data() + panel * dimension * width, dimension, rankBound, partial);
+        for (size_t j = 0; j < width; ++j) {
+            const uint32_t row = panelRows[panel * width + j];
+            if (partial[j] <= rankBound && row != kEmptySlot) {
+                double distance = kernel(query, vectors.row(row), dimension);
+                if (distance <= selector.threshold()) {
+                    selector.push(distance, vectors.label(row));
+                    refreshBounds();
+                }
+            }
+        }
+    };
+
+    const size_t count = panelCount();
+    if (pivots == 0) {
+        for (size_t panel = 0; panel < count; ++panel) {
+            scanPanel(panel);
+        }
+        return;
+    }
+
+    // Premier panneau dont les distances au premier pivot atteignent celle de la requête, puis
+    // parcours vers l'extérieur en prenant toujours le côté le plus proche sur ce pivot.
+    const double anchor = queryPivots[0];
+    size_t right = 0;
+    size_t last = count;
+    while (right < last) {
+        size_t middle = (right + last) / 2;
+        if (pivotHigh[middle * pivots] < anchor) {
+            right = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    size_t left = right;
+    while (left > 0 || right < count) {
+        refreshBounds();
+        const double leftGap = left > 0 ? anchor - pivotHigh[(left - 1) * pivots] : numeric_limits<double>::infinity();
+        const double rightGap = right < count ? pivotLow[right * pivots] - anchor : numeric_limits<double>::infinity();
+        const bool goLeft = leftGap <= rightGap;
+        const double gap = goLeft ? leftGap : rightGap;
+        const double scale = anchor + (goLeft ? pivotHigh[(left - 1) * pivots] : pivotLow[right * pivots]);
+        if (outOfReach(gap, scale)) {
+            break;
+        }
+        scanPanel(goLeft ? --left : right++);
+    }
+}
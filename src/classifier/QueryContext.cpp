@@ -0,0 +1,30 @@
+#include "classifier/QueryContext.h"
+#include <algorithm>
+
+using namespace std;
+
+pair<int, int> QueryContext::vote(const vector<TopKSelector::Neighbor>& neighbors, int labelBase, size_t labelCount) {
+    if (votes.size() < labelCount) {
+        votes.resize(labelCount, 0);
+    }
+
+    int bestCount = 0;
+    for (const auto& neighbor : neighbors) {
+        int& count = votes[neighbor.second - labelBase];
+        bestCount = max(bestCount, ++count);
+    }
+
+    // Second passage dans l'ordre des distances : le premier label qui atteint le maximum gagne.
+    // Chaque case est remise à zéro après sa première lecture.
+    int bestLabel = -1;
+    bool decided = false;
+    for (const auto& neighbor : neighbors) {
+        int& count = votes[neighbor.second - labelBase];
+        if (!decided && count == bestCount) {
+            bestLabel = neighbor.second;
+            decided = true;
+        }
+        count = 0;
+    }
+    return make_pair(bestLabel, bestCount);
+}
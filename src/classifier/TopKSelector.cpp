@@ -0,0 +1,46 @@
+#include "classifier/TopKSelector.h"
+#include <algorithm>
+
+using namespace std;
+
+void TopKSelector::reset(size_t kValue) {
+    k = kValue;
+    sorted = (k <= kInsertionLimit);
+    // Avec K = 0, aucun candidat ne peut battre `worst`.
+    worst = (k == 0) ? Neighbor(-numeric_limits<double>::infinity(), numeric_limits<int>::min()) : unreachable();
+    buffer.clear();
+    buffer.reserve(sorted ? k : 2 * k);
+}
+
+void TopKSelector::insertSorted(const Neighbor& candidate) {
+    if (buffer.size() == k) {
+        buffer.pop_back();
+    }
+    // Petit tampon : décalage linéaire depuis la fin.
+    buffer.push_back(candidate);
+    size_t i = buffer.size() - 1;
+    while (i > 0 && candidate < buffer[i - 1]) {
+        buffer[i] = buffer[i - 1];
+        --i;
+    }
+    buffer[i] = candidate;
+    if (buffer.size() == k) {
+        worst = buffer.back();
+    }
+}
+
+void TopKSelector::shrink() {
+    nth_element(buffer.begin(), buffer.begin() + (k - 1), buffer.end());
+    buffer.resize(k);
+    worst = buffer[k - 1];
+}
+
+void TopKSelector::finish(vector<Neighbor>& out) {
+    if (!sorted) {
+        if (buffer.size() > k) {
+            shrink();
+        }
+        sort(buffer.begin(), buffer.end());
+    }
+    out.assign(buffer.begin(), buffer.end());
+}
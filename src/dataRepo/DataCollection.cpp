@@ -1,5 +1,8 @@
 #include "dataRepo/DataCollection.h"
+#include "dataRepo/DescriptorParser.h"
+#include "parallel/ThreadPool.h"
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <filesystem> 
 #include <algorithm>
@@ -12,7 +15,7 @@
 using namespace std;
 namespace fs = std::filesystem; 
 
-DataCollection::DataCollection() : representationType("") {}
+DataCollection::DataCollection() : representation(RepresentationId::Unknown) {}
 
 int DataCollection::extractLabelFromFilename(const string& filename) {
     if (filename.length() >= 7 && filename[0] == 's' && filename[3] == 'n') {
@@ -33,7 +36,8 @@ bool DataCollection::addDatapoint(const Image& img) {
         return false;
     }
 
-    if (dataset.find(img) != dataset.end()) {
+    uint64_t fingerprint = img.fingerprint();
+    if (datasetIndex.contains(fingerprint, [this, &img](size_t i) { return dataset[i] == img; })) {
         cerr << "Image déjà présente dans le dataset : " << img.getImagePath() << endl;
         return false;  
     }
@@ -44,15 +48,26 @@ bool DataCollection::addDatapoint(const Image& img) {
         return false; 
     }
 
-    dataset[img] = label;  
+    datasetIndex.insert(fingerprint, dataset.size());
+    dataset.push_back(img);
     sampleCounts[label]++;
     return true;  
 }
 
-bool DataCollection::loadDatasetFromDirectory(const string& dirPath) {
+bool DataCollection::loadDatasetFromDirectory(const string& dirPath, size_t numThreads) {
+    struct PendingFile {
+        string path;
+        int label;
+        bool parsed = false;
+        vector<double> descriptors;
+        RepresentationId representation = RepresentationId::Unknown;
+    };
+
     size_t totalImages = 0;
     unordered_map<string, size_t> fileCountsByExtension;
 
+    // 1. Liste des fichiers, triée par chemin pour un résultat déterministe.
+    vector<PendingFile> files;
     for (const auto& entry : fs::recursive_directory_iterator(dirPath)) {
         if (fs::is_regular_file(entry.path())) {
             string filename = entry.path().filename().string();
@@ -67,27 +82,69 @@ bool DataCollection::loadDatasetFromDirectory(const string& dirPath) {
                     }
 
                     fileCountsByExtension[extension]++; 
-
-                    try {
-                        DataRepresentation rep(entry.path().string());
-                        if (rep.readFile()) {
-                            vector<double> descriptors = rep.getData();
-                            string currentType = rep.getRepresentationType();
-
-                            Image img(descriptors, label, currentType, entry.path().string());
-                            if (!addDatapoint(img)) {
-                                cerr << "Erreur lors de l'ajout de l'image : " << entry.path() << endl;
-                            } else {
-                                totalImages++;
-                            }
-                        }
-                    } catch (const runtime_error& e) {
-                        cerr << "Erreur lors du traitement de l'image : " << e.what() << endl;
-                    }
+                    PendingFile file;
+                    file.path = entry.path().string();
+                    file.label = label;
+                    files.push_back(std::move(file));
                 }
             }
         }
     }
+    sort(files.begin(), files.end(), [](const PendingFile& a, const PendingFile& b) {
+        return a.path < b.path;
+    });
+
+    // 2. Lecture en parallèle, chaque thread garde sa propre liste d'erreurs. Une erreur sur un
+    //    fichier n'interrompt pas le chargement des autres.
+    unique_ptr<ThreadPool> privatePool;
+    ThreadPool& pool = ThreadPool::select(numThreads, privatePool);
+    vector<vector<pair<size_t, string>>> errorsByWorker(pool.size());
+    pool.parallelFor(files.size(), [&files, &errorsByWorker](size_t i, size_t worker) {
+        PendingFile& file = files[i];
+        string errorMessage;
+        try {
+            size_t expectedDimension = DescriptorParser::expectedDimensionForPath(file.path);
+            file.parsed = DescriptorParser::parseFile(file.path, file.descriptors, expectedDimension, errorMessage);
+            if (file.parsed) {
+                file.representation = representationFromDimension(file.descriptors.size());
+                if (file.representation == RepresentationId::Unknown) {
+                    errorMessage = "Type de descripteurs inconnu avec " + to_string(file.descriptors.size()) + " descripteurs.";
+                }
+            }
+        } catch (const runtime_error& e) {
+            file.parsed = false;
+            errorMessage = string("Erreur lors du traitement de l'image : ") + e.what();
+        }
+        if (!errorMessage.empty()) {
+            errorsByWorker[worker].emplace_back(i, errorMessage);
+        }
+    });
+
+    vector<pair<size_t, string>> errors;
+    for (auto& workerErrors : errorsByWorker) {
+        errors.insert(errors.end(), workerErrors.begin(), workerErrors.end());
+    }
+    sort(errors.begin(), errors.end());
+    for (const auto& error : errors) {
+        cerr << error.second << endl;
+    }
+
+    // 3. Fusion séquentielle dans l'ordre des chemins.
+    dataset.reserve(dataset.size() + files.size());
+    for (PendingFile& file : files) {
+        if (!file.parsed) continue;
+
+        try {
+            Image img(std::move(file.descriptors), file.label, file.representation, file.path);
+            if (!addDatapoint(img)) {
+                cerr << "Erreur lors de l'ajout de l'image : " << fs::path(file.path) << endl;
+            } else {
+                totalImages++;
+            }
+        } catch (const runtime_error& e) {
+            cerr << "Erreur lors du traitement de l'image : " << e.what() << endl;
+        }
+    }
 
     cout << "=== Résumé du chargement ===" << endl;
     cout << "Total des images chargées : " << totalImages << endl;
@@ -99,6 +156,69 @@ bool DataCollection::loadDatasetFromDirectory(const string& dirPath) {
     return true;
 }
 
+bool DataCollection::loadDatasetFromStore(const string& storePath) {
+    DescriptorStore store;
+    if (!store.open(storePath)) {
+        return false;
+    }
+
+    size_t totalImages = 0;
+    const size_t dimension = store.dimension();
+    vector<double> descriptors(dimension);
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store.elementType() == DescriptorStore::ElementType::Float64) {
+            const double* row = store.rowDouble(i);
+            descriptors.assign(row, row + dimension);
+        } else {
+            const float* row = store.rowFloat(i);
+            descriptors.assign(row, row + dimension);
+        }
+
+        Image img(descriptors, store.label(i), store.getRepresentationId(), string(store.path(i)));
+        if (!addDatapoint(img)) {
+            cerr << "Erreur lors de l'ajout de l'image : " << store.path(i) << endl;
+        } else {
+            totalImages++;
+        }
+    }
+
+    cout << "=== Résumé du chargement ===" << endl;
+    cout << "Total des images chargées : " << totalImages << endl;
+    cout << "Fichier " << storePath << " : " << store.getRepresentationType()
+         << ", " << dimension << " descripteurs par image" << endl;
+    cout << "============================" << endl;
+
+    return true;
+}
+
+bool DataCollection::loadMatrixFromStore(const string& storePath, FeatureMatrix& matrix) {
+    DescriptorStore store;
+    if (!store.open(storePath)) {
+        return false;
+    }
+    if (store.getRepresentationId() == RepresentationId::Unknown
+        || store.dimension() != representationDimension(store.getRepresentationId())) {
+        cerr << "Erreur : Représentation inconnue ou dimension incorrecte dans " << storePath << endl;
+        return false;
+    }
+    for (size_t i = 0; i < store.size(); ++i) {
+        if (store.label(i) < 1 || store.label(i) > 18) {
+            cerr << "Erreur : Classe " << store.label(i) << " hors limite dans " << storePath << endl;
+            return false;
+        }
+    }
+
+    // La vue garde le fichier mappé : `store` peut être fermé.
+    matrix = store.view();
+
+    cout << "=== Résumé du chargement ===" << endl;
+    cout << "Total des images chargées : " << matrix.rows() << endl;
+    cout << "Fichier " << storePath << " : " << store.getRepresentationType()
+         << ", " << store.dimension() << " descripteurs par image" << endl;
+    cout << "============================" << endl;
+    return true;
+}
+
 // Affichage d'un résumé du dataset
 void DataCollection::printDataset() const {
     unordered_map<string, size_t> typeCounts;
@@ -107,8 +227,7 @@ void DataCollection::printDataset() const {
     unordered_map<string, size_t> descriptorsPerFileByType;
     size_t totalDescriptors = 0;
 
-    for (const auto& entry : dataset) {
-        const Image& img = entry.first;
+    for (const Image& img : dataset) {
         const string& representationType = img.getRepresentationType();
         size_t numDescriptors = img.getDescripteurs().size();
 
@@ -141,12 +260,31 @@ void DataCollection::printDataset() const {
 }
 
 // Récupération des images
-vector<Image> DataCollection::getImages() const {
-    vector<Image> images;
-    for (const auto& entry : dataset) {
-        images.push_back(entry.first);
+const vector<Image>& DataCollection::getImages() const {
+    return dataset;
+}
+
+FeatureMatrix DataCollection::getFeatureMatrix() const {
+    return buildFeatureMatrix(getImages());
+}
+
+FeatureMatrix DataCollection::buildFeatureMatrix(const vector<Image>& images, FeatureMatrix::Layout layout) {
+    if (images.empty()) {
+        return FeatureMatrix();
     }
-    return images;
+
+    RepresentationId type = images[0].getRepresentationId();
+    size_t dimension = images[0].getDescripteurs().size();
+    FeatureMatrix matrix(images.size(), dimension, type, layout);
+
+    for (size_t i = 0; i < images.size(); ++i) {
+        const Image& img = images[i];
+        if (img.getRepresentationId() != type || img.getDescripteurs().size() != dimension) {
+            throw invalid_argument("Images non homogènes pour la construction de la FeatureMatrix.");
+        }
+        matrix.setRow(i, img.getDescripteurs(), img.getLabel(), img.getImagePath());
+    }
+    return matrix;
 }
 
 // Division du dataset en ensemble d'entraînement et de test
@@ -164,11 +302,11 @@ void DataCollection::splitDataset(const std::vector<Image>& dataset, std::vector
 }
 
 
-std::unordered_map<std::string, std::vector<Image>> DataCollection::groupImagesByRepresentation(const std::vector<Image>& images) const {
-    std::unordered_map<std::string, std::vector<Image>> groupedImages;
+std::unordered_map<RepresentationId, std::vector<Image>> DataCollection::groupImagesByRepresentation(const std::vector<Image>& images) const {
+    std::unordered_map<RepresentationId, std::vector<Image>> groupedImages;
 
     for (const auto& img : images) {
-        groupedImages[img.getRepresentationType()].push_back(img);
+        groupedImages[img.getRepresentationId()].push_back(img);
     }
 
     return groupedImages;
@@ -205,6 +343,45 @@ void DataCollection::normalizeDataset(std::vector<Image>& images) {
     }
 }
 
+void DataCollection::computeNormalizationBounds(const FeatureMatrix& matrix) {
+    if (matrix.empty()) return;
+
+    const size_t descriptorSize = matrix.dimension();
+    minValues.assign(descriptorSize, std::numeric_limits<double>::max());
+    maxValues.assign(descriptorSize, std::numeric_limits<double>::lowest());
+
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        for (size_t i = 0; i < descriptorSize; ++i) {
+            const double value = matrix.at(row, i);
+            minValues[i] = std::min(minValues[i], value);
+            maxValues[i] = std::max(maxValues[i], value);
+        }
+    }
+}
+
+FeatureMatrix DataCollection::normalizeMatrix(FeatureMatrix matrix) const {
+    if (matrix.dimension() != minValues.size()) {
+        throw invalid_argument("Bornes de normalisation incompatibles avec la FeatureMatrix.");
+    }
+
+    // Normalisation sur place : une vue est d'abord copiée (une seule fois), une matrice propre
+    // passée par déplacement ne l'est pas.
+    if (matrix.isView()) {
+        matrix.detach();
+    }
+    for (size_t row = 0; row < matrix.rows(); ++row) {
+        double* values = matrix.mutableRow(row);
+        for (size_t i = 0; i < matrix.dimension(); ++i) {
+            if (maxValues[i] != minValues[i]) {
+                values[i] = (values[i] - minValues[i]) / (maxValues[i] - minValues[i]);
+            } else {
+                values[i] = 0.0; // Cas où les valeurs sont constantes
+            }
+        }
+    }
+    return matrix;
+}
+
 void DataCollection::savePRData(const std::string& filename, const std::vector<int>& trueLabels, const std::vector<double>& confidenceScores) {
     std::ofstream outFile(filename);
     if (!outFile.is_open()) {
@@ -1,35 +1,35 @@
 #include <iostream>
 #include "dataRepo/DataRepresentation.h"
 #include "dataRepo/Image.h" 
+#include "dataRepo/DescriptorParser.h"
 #include <fstream>
 #include <filesystem>
 namespace filesystem = std::filesystem;
 
 using namespace std;
 
-DataRepresentation::DataRepresentation(const string& path) : filePath(path) {}
+DataRepresentation::DataRepresentation(const string& path)
+    : filePath(path), representation(RepresentationId::Unknown) {}
 
 
 bool DataRepresentation::readFile() {
-    data.clear();
-    ifstream file(filePath);
-    if (!file.is_open()) {
-        cerr << "Erreur : Impossible d'ouvrir le fichier " << filePath << endl;
-        return false;
-    }
-
-    double value;
-    while (file >> value) {
-        data.push_back(value);
+    string errorMessage;
+    bool success = readFile(errorMessage);
+    if (!errorMessage.empty()) {
+        cerr << errorMessage << endl;
     }
+    return success;
+}
 
-    if (file.bad()) {
-        cerr << "Erreur lors de la lecture du fichier : " << filePath << endl;
+bool DataRepresentation::readFile(string& errorMessage) {
+    errorMessage.clear();
+    if (!DescriptorParser::parseFile(filePath, data, DescriptorParser::expectedDimensionForPath(filePath), errorMessage)) {
         return false;
     }
 
-    file.close();
-    determineRepresentationType();
+    if (!determineRepresentationType()) {
+        errorMessage = "Type de descripteurs inconnu avec " + to_string(data.size()) + " descripteurs.";
+    }
     return true;
 }
 
@@ -38,7 +38,11 @@ const vector<double>& DataRepresentation::getData() const {
 }
 
 const string& DataRepresentation::getRepresentationType() const {
-    return representationType;
+    return representationName(representation);
+}
+
+RepresentationId DataRepresentation::getRepresentationId() const {
+    return representation;
 }
 
 bool DataRepresentation::loadFromDirectory(const string& dirPath, const string& pgmDir, vector<Image>& images) {
@@ -60,7 +64,7 @@ bool DataRepresentation::loadFromDirectory(const string& dirPath, const string&
                 string imagePath = pgmDir + "/" + filename.substr(0, 7) + ".pgm";
                 int label = extractLabelFromFilename(filename);
 
-                Image img(limitedData, label, rep.getRepresentationType(), imagePath);
+                Image img(limitedData, label, rep.getRepresentationId(), imagePath);
                 images.push_back(img);
                 sampleCounts[classLabel]++;
             } else {
@@ -71,20 +75,9 @@ bool DataRepresentation::loadFromDirectory(const string& dirPath, const string&
     return true;
 }
 
-void DataRepresentation::determineRepresentationType() {
-
-    if (data.size() == 18) {
-        representationType = "Zernike7";
-    } else if (data.size() == 100) {
-        representationType = "GFD";
-    } else if (data.size() == 36) {
-        representationType = "ART";
-    } else if (data.size() == 29) {
-        representationType = "Yang";
-    } else {
-        cerr << "Type de descripteurs inconnu avec " << data.size() << " descripteurs." << endl;
-        representationType = "UNKNOWN";
-    }
+bool DataRepresentation::determineRepresentationType() {
+    representation = representationFromDimension(data.size());
+    return representation != RepresentationId::Unknown;
 }
 
 int DataRepresentation::extractLabelFromFilename(const string& filename) {
@@ -0,0 +1,140 @@
+#include "dataRepo/DescriptorBatchReader.h"
+#include "dataRepo/DescriptorParser.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+DescriptorBatchReader::DescriptorBatchReader(size_t numThreads)
+    : pool(ThreadPool::select(numThreads, ownPool)), representation(RepresentationId::Unknown), position(0) {}
+
+bool DescriptorBatchReader::open(const string& path) {
+    store.close();
+    files.clear();
+    representation = RepresentationId::Unknown;
+    position = 0;
+
+    if (fs::is_directory(path)) {
+        return openDirectory(path);
+    }
+    if (!store.open(path)) {
+        return false;
+    }
+    representation = store.getRepresentationId();
+    if (store.size() == 0 || representation == RepresentationId::Unknown) {
+        cerr << "Erreur : Aucun descripteur exploitable dans " << path << endl;
+        store.close();
+        return false;
+    }
+    return true;
+}
+
+bool DescriptorBatchReader::openDirectory(const string& dirPath) {
+    // Mêmes fichiers que `DataCollection::loadDatasetFromDirectory` (nom sXXnYYY, classes 1 à 18).
+    for (const auto& entry : fs::recursive_directory_iterator(dirPath)) {
+        if (!fs::is_regular_file(entry.path())) continue;
+        const string filename = entry.path().filename().string();
+        const string filePath = entry.path().string();
+        if (DescriptorParser::expectedDimensionForPath(filePath) == 0) continue;
+        if (filename.length() < 7 || filename[0] != 's' || filename[3] != 'n') continue;
+        int label = stoi(filename.substr(1, 2));
+        if (label < 1 || label > 18) continue;
+        files.emplace_back(filePath, label);
+    }
+    sort(files.begin(), files.end());
+    if (files.empty()) {
+        cerr << "Erreur : Aucun fichier de descripteurs dans " << dirPath << endl;
+        return false;
+    }
+
+    const size_t dimension = DescriptorParser::expectedDimensionForPath(files.front().first);
+    representation = representationFromDimension(dimension);
+    size_t skipped = 0;
+    files.erase(remove_if(files.begin(), files.end(),
+                          [dimension, &skipped](const pair<string, int>& file) {
+                              bool other = DescriptorParser::expectedDimensionForPath(file.first) != dimension;
+                              skipped += other ? 1 : 0;
+                              return other;
+                          }),
+                files.end());
+    if (skipped > 0) {
+        cerr << "Avertissement : " << skipped << " fichiers d'une autre représentation que "
+             << representationName(representation) << " ignorés dans " << dirPath << endl;
+    }
+    return true;
+}
+
+size_t DescriptorBatchReader::size() const {
+    return store.isOpen() ? store.size() : files.size();
+}
+
+bool DescriptorBatchReader::next(FeatureMatrix& batch, size_t batchSize) {
+    if (batchSize == 0) {
+        return false;
+    }
+    return store.isOpen() ? nextFromStore(batch, batchSize) : nextFromDirectory(batch, batchSize);
+}
+
+bool DescriptorBatchReader::nextFromStore(FeatureMatrix& batch, size_t batchSize) {
+    const size_t count = min(batchSize, store.size() - position);
+    if (count == 0) {
+        return false;
+    }
+    const size_t dimension = store.dimension();
+    batch = FeatureMatrix(count, dimension, representation);
+    for (size_t i = 0; i < count; ++i) {
+        double* target = batch.mutableRow(i);
+        if (store.elementType() == DescriptorStore::ElementType::Float64) {
+            const double* values = store.rowDouble(position + i);
+            copy(values, values + dimension, target);
+        } else {
+            const float* values = store.rowFloat(position + i);
+            copy(values, values + dimension, target);
+        }
+        batch.setLabel(i, store.label(position + i));
+        batch.setPath(i, string(store.path(position + i)));
+    }
+    position += count;
+    return true;
+}
+
+bool DescriptorBatchReader::nextFromDirectory(FeatureMatrix& batch, size_t batchSize) {
+    const size_t dimension = representationDimension(representation);
+    while (position < files.size()) {
+        const size_t count = min(batchSize, files.size() - position);
+        vector<vector<double>> descriptors(count);
+        vector<string> errors(count);
+        vector<char> parsed(count, 0);
+        pool.parallelFor(count, [&](size_t i, size_t) {
+            parsed[i] = DescriptorParser::parseFile(files[position + i].first, descriptors[i], dimension, errors[i])
+                     && descriptors[i].size() == dimension;
+            if (!parsed[i] && errors[i].empty()) {
+                errors[i] = "Nombre de descripteurs incorrect dans " + files[position + i].first;
+            }
+        });
+
+        size_t valid = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (parsed[i]) {
+                ++valid;
+            } else {
+                cerr << errors[i] << endl;
+            }
+        }
+        if (valid > 0) {
+            batch = FeatureMatrix(valid, dimension, representation);
+            for (size_t i = 0, row = 0; i < count; ++i) {
+                if (parsed[i]) {
+                    batch.setRow(row++, descriptors[i], files[position + i].second, files[position + i].first);
+                }
+            }
+        }
+        position += count;
+        if (valid > 0) {
+            return true;
+        }
+    }
+    return false;
+}
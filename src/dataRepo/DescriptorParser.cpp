@@ -0,0 +1,97 @@
+#include "dataRepo/DescriptorParser.h"
+#include "dataRepo/RepresentationTraits.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+
+using namespace std;
+
+namespace {
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    // Lit tout le fichier dans `buffer` (dont la capacité est conservée entre deux appels).
+    bool readWholeFile(const string& path, vector<char>& buffer) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+
+        buffer.clear();
+        size_t used = 0;
+        for (;;) {
+            if (buffer.size() - used < 4096) {
+                buffer.resize(buffer.size() + 16384);
+            }
+            size_t read = fread(buffer.data() + used, 1, buffer.size() - used, file);
+            used += read;
+            if (read == 0) break;
+        }
+        bool ok = !ferror(file);
+        fclose(file);
+        buffer.resize(used);
+        return ok;
+    }
+}
+
+bool DescriptorParser::parseFile(const string& path, vector<double>& out, size_t expectedDimension, string& errorMessage) {
+    thread_local vector<char> buffer;
+
+    out.clear();
+    if (!readWholeFile(path, buffer)) {
+        errorMessage = "Erreur : Impossible d'ouvrir le fichier " + path;
+        return false;
+    }
+
+    out.reserve(expectedDimension);
+    parseBuffer(buffer.data(), buffer.data() + buffer.size(), out);
+    return true;
+}
+
+void DescriptorParser::parseBuffer(const char* begin, const char* end, vector<double>& out) {
+    const char* cursor = begin;
+    for (;;) {
+        while (cursor != end && isSpace(*cursor)) ++cursor;
+        if (cursor == end) return;
+
+        // Comme operator>> : un seul signe, suivi d'un chiffre ou d'un point. Cela écarte aussi
+        // "inf" et "nan", que from_chars accepte mais pas le flux. from_chars n'accepte pas le '+'
+        // initial, il est donc sauté.
+        const char* digits = (*cursor == '+' || *cursor == '-') ? cursor + 1 : cursor;
+        if (digits == end || !(isDigit(*digits) || *digits == '.')) return;
+        const char* number = (*cursor == '+') ? digits : cursor;
+
+        double value;
+        auto result = from_chars(number, end, value);
+        if (result.ec == errc::result_out_of_range) {
+            // Le flux refuse un dépassement mais garde la valeur arrondie (0 ou dénormale) d'un
+            // sous-dépassement : strtod donne la même valeur.
+            value = strtod(string(number, result.ptr).c_str(), nullptr);
+            if (isinf(value)) return;
+        } else if (result.ec != errc()) {
+            return;
+        }
+        // Un exposant incomplet ("1e", "1e+") fait échouer tout le nombre avec operator>>, alors
+        // que from_chars s'arrête avant le 'e'.
+        if (result.ptr != end && (*result.ptr == 'e' || *result.ptr == 'E')
+            && find_if(number, result.ptr, [](char c) { return c == 'e' || c == 'E'; }) == result.ptr) {
+            return;
+        }
+
+        out.push_back(value);
+        cursor = result.ptr;
+    }
+}
+
+size_t DescriptorParser::expectedDimensionForPath(const string& path) {
+    string extension = filesystem::path(path).extension().string();
+    return representationDimension(representationFromExtension(extension));
+}
@@ -0,0 +1,287 @@
+#include "dataRepo/DescriptorStore.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+    const char kMagic[8] = {'R', 'F', 'D', 'S', 'T', 'O', 'R', 'E'};
+    const uint32_t kByteOrderMark = 0x01020304;
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // a * b et a + b sur 64 bits : false si le résultat déborde (fichier corrompu).
+    bool multiplyChecked(uint64_t a, uint64_t b, uint64_t& result) {
+        if (a != 0 && b > numeric_limits<uint64_t>::max() / a) {
+            return false;
+        }
+        result = a * b;
+        return true;
+    }
+
+    bool addChecked(uint64_t a, uint64_t b, uint64_t& result) {
+        if (b > numeric_limits<uint64_t>::max() - a) {
+            return false;
+        }
+        result = a + b;
+        return true;
+    }
+
+    // Libère le mapping quand plus aucune vue ne l'utilise.
+    struct MappedFile {
+        void* address;
+        size_t length;
+        ~MappedFile() { munmap(address, length); }
+    };
+}
+
+DescriptorStore::DescriptorStore()
+    : base(nullptr), length(0), count(0), dim(0), rowStride(0), type(ElementType::Float64),
+      representation(RepresentationId::Unknown),
+      labelTable(nullptr), pathOffsets(nullptr), pathChars(nullptr), dataBlock(nullptr) {}
+
+DescriptorStore::~DescriptorStore() {
+    close();
+}
+
+bool DescriptorStore::write(const string& filePath, const FeatureMatrix& matrix, ElementType elementType) {
+    if (matrix.layout() != FeatureMatrix::Layout::RowMajor) {
+        return write(filePath, matrix.toLayout(FeatureMatrix::Layout::RowMajor), elementType);
+    }
+
+    const string& representation = matrix.getRepresentationType();
+    Header header{};
+    if (representation.size() >= sizeof(header.representation)) {
+        cerr << "Erreur : Nom de représentation trop long : " << representation << endl;
+        return false;
+    }
+
+    uint64_t rows = matrix.rows();
+    uint64_t stride = alignUp(matrix.dimension(), FeatureMatrix::kPadding); // Même stride que FeatureMatrix pour la vue sans copie.
+
+    vector<uint64_t> offsets(rows + 1, 0);
+    for (uint64_t i = 0; i < rows; ++i) {
+        offsets[i + 1] = offsets[i] + matrix.path(i).size();
+    }
+
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.elementType = static_cast<uint32_t>(elementType);
+    header.dimension = static_cast<uint32_t>(matrix.dimension());
+    header.stride = static_cast<uint32_t>(stride);
+    header.count = rows;
+    header.labelTableOffset = sizeof(Header);
+    header.pathTableOffset = alignUp(header.labelTableOffset + rows * sizeof(int32_t), sizeof(uint64_t));
+    header.dataOffset = alignUp(header.pathTableOffset + offsets.size() * sizeof(uint64_t) + offsets.back(), kDataAlignment);
+    memcpy(header.representation, representation.data(), representation.size());
+
+    ofstream out(filePath, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Erreur : Impossible de créer le fichier " << filePath << endl;
+        return false;
+    }
+
+    auto padTo = [&out](uint64_t position) {
+        static const char zeros[kDataAlignment] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        if (position > current) {
+            out.write(zeros, position - current);
+        }
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (uint64_t i = 0; i < rows; ++i) {
+        int32_t label = matrix.label(i);
+        out.write(reinterpret_cast<const char*>(&label), sizeof(label));
+    }
+    padTo(header.pathTableOffset);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    for (uint64_t i = 0; i < rows; ++i) {
+        out.write(matrix.path(i).data(), matrix.path(i).size());
+    }
+    padTo(header.dataOffset);
+
+    if (elementType == ElementType::Float32) {
+        vector<float> row(stride, 0.0f);
+        for (uint64_t i = 0; i < rows; ++i) {
+            const double* values = matrix.row(i);
+            for (size_t j = 0; j < matrix.dimension(); ++j) {
+                row[j] = static_cast<float>(values[j]);
+            }
+            out.write(reinterpret_cast<const char*>(row.data()), stride * sizeof(float));
+        }
+    } else {
+        vector<double> row(stride, 0.0);
+        for (uint64_t i = 0; i < rows; ++i) {
+            const double* values = matrix.row(i);
+            copy(values, values + matrix.dimension(), row.begin());
+            out.write(reinterpret_cast<const char*>(row.data()), stride * sizeof(double));
+        }
+    }
+
+    if (!out.good()) {
+        cerr << "Erreur lors de l'écriture du fichier : " << filePath << endl;
+        return false;
+    }
+    return true;
+}
+
+bool DescriptorStore::open(const string& filePath) {
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Erreur : Impossible d'ouvrir le fichier " << filePath << endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        cerr << "Erreur : Fichier de descripteurs invalide : " << filePath << endl;
+        ::close(fd);
+        return false;
+    }
+
+    size_t fileLength = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, fileLength, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        cerr << "Erreur : mmap impossible pour " << filePath << endl;
+        return false;
+    }
+
+    auto mapped = make_shared<MappedFile>();
+    mapped->address = address;
+    mapped->length = fileLength;
+
+    Header header;
+    memcpy(&header, address, sizeof(header));
+
+    bool valid = memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+        && header.version == kVersion
+        && header.byteOrderMark == kByteOrderMark
+        && (header.elementType == static_cast<uint32_t>(ElementType::Float32)
+            || header.elementType == static_cast<uint32_t>(ElementType::Float64))
+        && header.stride >= header.dimension
+        && header.representation[sizeof(header.representation) - 1] == '\0';
+
+    // Toutes les tailles viennent du fichier : chaque produit et chaque somme est vérifié avant
+    // d'être comparé à la taille réelle du fichier.
+    const uint64_t elementSize = (header.elementType == static_cast<uint32_t>(ElementType::Float32)) ? sizeof(float) : sizeof(double);
+    uint64_t labelBytes = 0, labelEnd = 0, offsetCount = 0, offsetBytes = 0, charsBegin = 0;
+    uint64_t dataElements = 0, dataBytes = 0, dataEnd = 0;
+    valid = valid
+        && header.labelTableOffset >= sizeof(Header)
+        && header.labelTableOffset % sizeof(int32_t) == 0
+        && multiplyChecked(header.count, sizeof(int32_t), labelBytes)
+        && addChecked(header.labelTableOffset, labelBytes, labelEnd)
+        && labelEnd <= header.pathTableOffset
+        && header.pathTableOffset % sizeof(uint64_t) == 0
+        && addChecked(header.count, 1, offsetCount)
+        && multiplyChecked(offsetCount, sizeof(uint64_t), offsetBytes)
+        && addChecked(header.pathTableOffset, offsetBytes, charsBegin)
+        && charsBegin <= header.dataOffset
+        && header.dataOffset % kDataAlignment == 0
+        && multiplyChecked(header.count, header.stride, dataElements)
+        && multiplyChecked(dataElements, elementSize, dataBytes)
+        && addChecked(header.dataOffset, dataBytes, dataEnd)
+        && dataEnd <= fileLength;
+
+    if (valid) {
+        // Offsets des chemins croissants et dans la zone des caractères : `path(i)` reste dans le fichier.
+        const uint64_t* offsets = reinterpret_cast<const uint64_t*>(static_cast<const unsigned char*>(address) + header.pathTableOffset);
+        valid = offsets[0] == 0 && offsets[header.count] <= header.dataOffset - charsBegin;
+        for (uint64_t i = 0; valid && i < header.count; ++i) {
+            valid = offsets[i] <= offsets[i + 1];
+        }
+    }
+
+    if (!valid) {
+        cerr << "Erreur : En-tête ou tables invalides, ou version non supportée : " << filePath << endl;
+        return false;
+    }
+
+    mapping = mapped;
+    base = static_cast<const unsigned char*>(address);
+    length = fileLength;
+    count = header.count;
+    dim = header.dimension;
+    rowStride = header.stride;
+    type = static_cast<ElementType>(header.elementType);
+    representation = representationFromName(header.representation);
+    labelTable = reinterpret_cast<const int32_t*>(base + header.labelTableOffset);
+    pathOffsets = reinterpret_cast<const uint64_t*>(base + header.pathTableOffset);
+    pathChars = reinterpret_cast<const char*>(pathOffsets + count + 1);
+    dataBlock = base + header.dataOffset;
+    return true;
+}
+
+void DescriptorStore::close() {
+    mapping.reset();
+    base = nullptr;
+    length = 0;
+    count = 0;
+    dim = 0;
+    rowStride = 0;
+    representation = RepresentationId::Unknown;
+    labelTable = nullptr;
+    pathOffsets = nullptr;
+    pathChars = nullptr;
+    dataBlock = nullptr;
+}
+
+int DescriptorStore::label(size_t i) const {
+    return labelTable[i];
+}
+
+string_view DescriptorStore::path(size_t i) const {
+    return string_view(pathChars + pathOffsets[i], pathOffsets[i + 1] - pathOffsets[i]);
+}
+
+const double* DescriptorStore::rowDouble(size_t i) const {
+    if (type != ElementType::Float64) return nullptr;
+    return reinterpret_cast<const double*>(dataBlock) + i * rowStride;
+}
+
+const float* DescriptorStore::rowFloat(size_t i) const {
+    if (type != ElementType::Float32) return nullptr;
+    return reinterpret_cast<const float*>(dataBlock) + i * rowStride;
+}
+
+FeatureMatrix DescriptorStore::view() const {
+    if (!isOpen()) {
+        return FeatureMatrix();
+    }
+
+    vector<int> labels(labelTable, labelTable + count);
+    vector<string> paths(count);
+    for (size_t i = 0; i < count; ++i) {
+        paths[i] = string(path(i));
+    }
+
+    if (type == ElementType::Float64) {
+        return FeatureMatrix::view(reinterpret_cast<const double*>(dataBlock), count, dim, rowStride,
+                                   representation, std::move(labels), std::move(paths), mapping);
+    }
+
+    FeatureMatrix matrix(count, dim, representation);
+    for (size_t i = 0; i < count; ++i) {
+        const float* values = rowFloat(i);
+        double* target = matrix.mutableRow(i);
+        for (size_t j = 0; j < dim; ++j) {
+            target[j] = values[j];
+        }
+        matrix.setLabel(i, labels[i]);
+        matrix.setPath(i, paths[i]);
+    }
+    return matrix;
+}
@@ -0,0 +1,141 @@
+#include "dataRepo/FeatureMatrix.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+    size_t paddedSize(size_t n) {
+        return (n + FeatureMatrix::kPadding - 1) / FeatureMatrix::kPadding * FeatureMatrix::kPadding;
+    }
+}
+
+FeatureMatrix::FeatureMatrix()
+    : numRows(0), numCols(0), rowStride(0), memoryLayout(Layout::RowMajor), representation(RepresentationId::Unknown),
+      first(nullptr), writable(nullptr), borrowed(false) {}
+
+FeatureMatrix::FeatureMatrix(size_t rows, size_t dimension, RepresentationId type, Layout layout)
+    : numRows(rows), numCols(dimension), memoryLayout(layout), representation(type), borrowed(false),
+      rowLabels(rows, 0), rowPaths(rows) {
+    rowStride = (layout == Layout::RowMajor) ? paddedSize(dimension) : paddedSize(rows);
+    storage = make_shared<Buffer>(valueCount(), 0.0);
+    first = writable = storage->data();
+}
+
+FeatureMatrix::FeatureMatrix(const FeatureMatrix& other)
+    : numRows(other.numRows), numCols(other.numCols), rowStride(other.rowStride), memoryLayout(other.memoryLayout),
+      representation(other.representation), owner(other.owner), first(other.first), writable(nullptr),
+      borrowed(other.borrowed), rowLabels(other.rowLabels), rowPaths(other.rowPaths) {
+    // Une matrice propre garde une sémantique de valeur : son buffer est copié.
+    if (other.storage) {
+        storage = make_shared<Buffer>(*other.storage);
+        first = writable = storage->data();
+    }
+}
+
+FeatureMatrix::FeatureMatrix(FeatureMatrix&& other) noexcept : FeatureMatrix() {
+    swap(other);
+}
+
+FeatureMatrix& FeatureMatrix::operator=(const FeatureMatrix& other) {
+    if (this != &other) {
+        FeatureMatrix copy(other);
+        swap(copy);
+    }
+    return *this;
+}
+
+FeatureMatrix& FeatureMatrix::operator=(FeatureMatrix&& other) noexcept {
+    FeatureMatrix moved(std::move(other));
+    swap(moved);
+    return *this;
+}
+
+void FeatureMatrix::swap(FeatureMatrix& other) noexcept {
+    std::swap(numRows, other.numRows);
+    std::swap(numCols, other.numCols);
+    std::swap(rowStride, other.rowStride);
+    std::swap(memoryLayout, other.memoryLayout);
+    std::swap(representation, other.representation);
+    storage.swap(other.storage);
+    owner.swap(other.owner);
+    std::swap(first, other.first);
+    std::swap(writable, other.writable);
+    std::swap(borrowed, other.borrowed);
+    rowLabels.swap(other.rowLabels);
+    rowPaths.swap(other.rowPaths);
+}
+
+void FeatureMatrix::throwBorrowed() {
+    throw logic_error("Écriture dans une vue de FeatureMatrix : appeler detach() d'abord.");
+}
+
+FeatureMatrix FeatureMatrix::view(const double* data, size_t rows, size_t dimension, size_t stride,
+                                  RepresentationId type, vector<int> labels, vector<string> paths,
+                                  shared_ptr<const void> owner) {
+    if (labels.size() != rows || paths.size() != rows || stride < dimension) {
+        throw invalid_argument("Paramètres de vue incohérents pour la FeatureMatrix.");
+    }
+    FeatureMatrix matrix;
+    matrix.numRows = rows;
+    matrix.numCols = dimension;
+    matrix.rowStride = stride;
+    matrix.representation = type;
+    matrix.rowLabels = std::move(labels);
+    matrix.rowPaths = std::move(paths);
+    matrix.first = data;
+    matrix.owner = std::move(owner);
+    matrix.borrowed = true;
+    return matrix;
+}
+
+void FeatureMatrix::detach() {
+    if (!borrowed) {
+        return;
+    }
+    storage = make_shared<Buffer>(first, first + valueCount());
+    first = writable = storage->data();
+    owner.reset();
+    borrowed = false;
+}
+
+void FeatureMatrix::setRow(size_t i, const vector<double>& descriptors, int label, const string& path) {
+    if (descriptors.size() != numCols) {
+        throw invalid_argument("Taille des descripteurs incompatible avec la FeatureMatrix.");
+    }
+    requireOwned();
+    for (size_t j = 0; j < numCols; ++j) {
+        writable[offset(i, j)] = descriptors[j];
+    }
+    rowLabels[i] = label;
+    rowPaths[i] = path;
+}
+
+Image FeatureMatrix::toImage(size_t i) const {
+    vector<double> descriptors(numCols);
+    for (size_t j = 0; j < numCols; ++j) {
+        descriptors[j] = at(i, j);
+    }
+    return Image(std::move(descriptors), rowLabels[i], representation, rowPaths[i]);
+}
+
+FeatureMatrix FeatureMatrix::slice(size_t begin, size_t end) const {
+    if (memoryLayout != Layout::RowMajor || begin > end || end > numRows) {
+        throw invalid_argument("Tranche de lignes invalide pour la FeatureMatrix.");
+    }
+    shared_ptr<const void> keepAlive = borrowed ? owner : shared_ptr<const void>(storage);
+    return view(first + begin * rowStride, end - begin, numCols, rowStride, representation,
+                vector<int>(rowLabels.begin() + begin, rowLabels.begin() + end),
+                vector<string>(rowPaths.begin() + begin, rowPaths.begin() + end), std::move(keepAlive));
+}
+
+FeatureMatrix FeatureMatrix::toLayout(Layout target) const {
+    FeatureMatrix converted(numRows, numCols, representation, target);
+    for (size_t i = 0; i < numRows; ++i) {
+        for (size_t j = 0; j < numCols; ++j) {
+            converted.writable[converted.offset(i, j)] = at(i, j);
+        }
+    }
+    converted.rowLabels = rowLabels;
+    converted.rowPaths = rowPaths;
+    return converted;
+}
@@ -0,0 +1,39 @@
+#include "dataRepo/FingerprintIndex.h"
+
+FingerprintIndex::FingerprintIndex() : count(0) {}
+
+void FingerprintIndex::insert(std::uint64_t fingerprint, std::size_t index) {
+    // Facteur de charge maximal de 0.7 pour garder des sondages courts.
+    if ((count + 1) * 10 > slots.size() * 7) {
+        grow();
+    }
+
+    std::size_t mask = slots.size() - 1;
+    std::size_t i = fingerprint & mask;
+    while (slots[i].index != kEmpty) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = {fingerprint, index};
+    ++count;
+}
+
+void FingerprintIndex::clear() {
+    slots.clear();
+    count = 0;
+}
+
+void FingerprintIndex::grow() {
+    std::vector<Slot> previous;
+    previous.swap(slots);
+    slots.assign(previous.empty() ? 64 : previous.size() * 2, Slot{0, kEmpty});
+
+    std::size_t mask = slots.size() - 1;
+    for (const Slot& slot : previous) {
+        if (slot.index == kEmpty) continue;
+        std::size_t i = slot.fingerprint & mask;
+        while (slots[i].index != kEmpty) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = slot;
+    }
+}
@@ -2,14 +2,18 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip> 
+#include <cstring>
 
 using namespace std;
 
 Image::Image() 
-    : descripteurs{}, label(0), representationType(""), imagePath("") {}
+    : descripteurs{}, label(0), representation(RepresentationId::Unknown), imagePath("") {}
 
 Image::Image(const std::vector<double>& d, int l, const std::string& type, const std::string& path)
-    : descripteurs(d), label(l), representationType(type), imagePath(path) {}
+    : descripteurs(d), label(l), representation(representationFromName(type)), imagePath(path) {}
+
+Image::Image(std::vector<double> d, int l, RepresentationId r, std::string path)
+    : descripteurs(std::move(d)), label(l), representation(r), imagePath(std::move(path)) {}
 
 const vector<double>& Image::getDescripteurs() const {
     return descripteurs;
@@ -24,7 +28,11 @@ int Image::getLabel() const {
 }
 
 const string& Image::getRepresentationType() const {
-    return representationType;
+    return representationName(representation);
+}
+
+RepresentationId Image::getRepresentationId() const {
+    return representation;
 }
 
 const string& Image::getImagePath() const {
@@ -32,7 +40,7 @@ const string& Image::getImagePath() const {
 }
 
 bool Image::isValidRepresentation(const string& expectedType) const {
-    return representationType == expectedType;
+    return representation == representationFromName(expectedType);
 }
 
 
@@ -41,16 +49,8 @@ bool Image::validateDescriptors(int expectedSize) const {
 }
 
 bool Image::validateDescriptorsForType() const {
-    if (representationType == "GFD" && descripteurs.size() != 100) {
-        return false;
-    } else if (representationType == "Yang" && descripteurs.size() != 29) {
-        return false;
-    } else if (representationType == "Zernike7" && descripteurs.size() != 18) {
-        return false;
-    } else if (representationType == "ART" && descripteurs.size() != 36) {
-        return false;
-    }
-    return true;
+    size_t expectedSize = representationDimension(representation);
+    return expectedSize == 0 || descripteurs.size() == expectedSize;
 }
 
 bool Image::operator<(const Image& other) const {
@@ -63,6 +63,31 @@ bool Image::operator<(const Image& other) const {
     return imagePath < other.imagePath;
 }
 
+bool Image::operator==(const Image& other) const {
+    return label == other.label && descripteurs == other.descripteurs && imagePath == other.imagePath;
+}
+
+namespace {
+    uint64_t mix(uint64_t hash, uint64_t word) {
+        hash ^= word;
+        hash *= 0x9E3779B97F4A7C15ULL;
+        return hash ^ (hash >> 32);
+    }
+}
+
+uint64_t Image::fingerprint() const {
+    uint64_t hash = mix(0xCBF29CE484222325ULL, static_cast<uint64_t>(label));
+    for (double value : descripteurs) {
+        uint64_t bits;
+        value = (value == 0.0) ? 0.0 : value; // -0.0 et 0.0 sont égaux pour operator==.
+        memcpy(&bits, &value, sizeof(bits));
+        hash = mix(hash, bits);
+    }
+    for (char c : imagePath) {
+        hash = mix(hash, static_cast<unsigned char>(c));
+    }
+    return mix(hash, imagePath.size());
+}
 
 bool Image::validateLabel(int minLabel, int maxLabel) const {
     return label >= minLabel && label <= maxLabel;
@@ -71,7 +96,7 @@ bool Image::validateLabel(int minLabel, int maxLabel) const {
 string Image::toString() const {
     ostringstream oss;
     oss << "Label : " << label 
-        << ", Type : " << representationType 
+        << ", Type : " << getRepresentationType() 
         << ", Descripteurs : ";
 
     for (size_t i = 0; i < min(descripteurs.size(), size_t(5)); ++i) {
@@ -0,0 +1,13 @@
+#include "dataRepo/RepresentationTraits.h"
+#include <array>
+
+const std::string& representationName(RepresentationId id) {
+    static const std::array<std::string, kRepresentationCount> names = [] {
+        std::array<std::string, kRepresentationCount> result;
+        for (std::size_t i = 0; i < kRepresentationCount; ++i) {
+            result[i] = kRepresentationTraits[i].name;
+        }
+        return result;
+    }();
+    return names[representationIndex(id)];
+}
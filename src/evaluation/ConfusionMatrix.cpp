@@ -9,6 +9,14 @@ void ConfusionMatrix::addPrediction(int trueLabel, int predictedLabel) {
     matrix[trueLabel - 1][predictedLabel - 1]++;
 }
 
+void ConfusionMatrix::merge(const ConfusionMatrix& other) {
+    for (int i = 0; i < numClasses; ++i) {
+        for (int j = 0; j < numClasses; ++j) {
+            matrix[i][j] += other.matrix[i][j];
+        }
+    }
+}
+
 void ConfusionMatrix::printMatrix() const {
     std::cout << "\n=== Confusion Matrix ===\n";
     for (const auto& row : matrix) {
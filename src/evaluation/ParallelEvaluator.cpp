@@ -0,0 +1,39 @@
+#include "evaluation/ParallelEvaluator.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+
+ParallelEvaluator::ParallelEvaluator(ThreadPool& threadPool, size_t size)
+    : pool(threadPool), shardSize(max<size_t>(1, size)) {}
+
+EvaluationResult ParallelEvaluator::evaluate(const FeatureMatrix& queries, int numClasses, const BatchPredictor& predict) const {
+    EvaluationResult result(numClasses);
+    const size_t numQueries = queries.rows();
+    result.trueLabels = queries.labels();
+    result.confidenceScores.assign(numQueries, 0.0);
+
+    const size_t numShards = (numQueries + shardSize - 1) / shardSize;
+    vector<ConfusionMatrix> perWorker(pool.size(), ConfusionMatrix(numClasses));
+
+    pool.parallelFor(numShards, [&](size_t shard, size_t worker) {
+        const size_t begin = shard * shardSize;
+        const size_t end = min(numQueries, begin + shardSize);
+        vector<pair<int, double>> predictions = predict(queries.slice(begin, end));
+        if (predictions.size() != end - begin) {
+            cerr << "Erreur : Le prédicteur a rendu " << predictions.size() << " prédictions pour "
+                 << end - begin << " requêtes." << endl;
+            throw runtime_error("Nombre de prédictions incorrect.");
+        }
+        for (size_t i = begin; i < end; ++i) {
+            perWorker[worker].addPrediction(result.trueLabels[i], predictions[i - begin].first);
+            result.confidenceScores[i] = predictions[i - begin].second;
+        }
+    });
+
+    for (const ConfusionMatrix& partial : perWorker) {
+        result.confusionMatrix.merge(partial);
+    }
+    return result;
+}
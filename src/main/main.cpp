@@ -5,11 +5,14 @@
 #include "classifier/KMeans.h"
 #include "evaluation/ConfusionMatrix.h"
 #include "evaluation/Metrics.h"
+#include "evaluation/ParallelEvaluator.h"
+#include "parallel/ThreadPool.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <memory>
 
 namespace fs = std::filesystem;
 using namespace std;
@@ -40,92 +43,130 @@ std::string getProjectRootDir(const char* argv0) {
 }
 
 
-void processRepresentation(const string& representationDir, const string& confusionDir, const string& metricsDir, const string& prDataDir) {
+/**
+ * Données et résultats d'une représentation.
+ */
+struct RepresentationRun {
+    string name;
+    DataCollection trainDataset;
+    FeatureMatrix trainMatrix;
+    FeatureMatrix testMatrix;
+    EvaluationResult knn{18};
+    EvaluationResult knnWithFixedK{18};
+    EvaluationResult kmeans{18};
+};
+
+/**
+ * Charge et normalise les données train/test d'une représentation.
+ * Entrée :
+ *   - representationDir (std::string) : Répertoire de la représentation.
+ *   - run (RepresentationRun&) : Reçoit les matrices d'entraînement et de test.
+ * Sortie (bool) : true si les données sont utilisables.
+ */
+bool loadRepresentation(const string& representationDir, RepresentationRun& run) {
     string trainDir = representationDir + "/train2";
     string testDir = representationDir + "/test2";
 
     if (!fs::exists(trainDir) || !fs::exists(testDir)) {
         cerr << "Erreur : Les répertoires train/test sont manquants pour : " << representationDir << endl;
-        return;
+        return false;
     }
 
-    DataCollection trainDataset, testDataset;
-    trainDataset.loadDatasetFromDirectory(trainDir);
-    testDataset.loadDatasetFromDirectory(testDir);
+    run.name = fs::path(representationDir).filename().string();
+
+    // Les fichiers binaires produits par scripts/pack_signatures sont utilisés s'ils existent :
+    // ils sont lus directement depuis le mapping, puis normalisés une seule fois dans les matrices.
+    if (fs::exists(trainDir + ".rfds") && fs::exists(testDir + ".rfds")) {
+        FeatureMatrix trainStore;
+        FeatureMatrix testStore;
+        if (!DataCollection::loadMatrixFromStore(trainDir + ".rfds", trainStore)
+            || !DataCollection::loadMatrixFromStore(testDir + ".rfds", testStore)
+            || trainStore.empty() || testStore.empty()
+            || trainStore.getRepresentationId() != testStore.getRepresentationId()) {
+            cout << "Données insuffisantes pour la représentation : " << representationDir << ". Passé.\n";
+            return false;
+        }
+        run.trainDataset.computeNormalizationBounds(trainStore);
+        run.trainMatrix = run.trainDataset.normalizeMatrix(std::move(trainStore));
+        run.testMatrix = run.trainDataset.normalizeMatrix(std::move(testStore));
+        return true;
+    }
 
-    vector<Image> trainImages = trainDataset.getImages();
-    vector<Image> testImages = testDataset.getImages();
+    DataCollection testDataset;
+    run.trainDataset.loadDatasetFromDirectory(trainDir);
+    testDataset.loadDatasetFromDirectory(testDir);
 
-    if (trainImages.empty() || testImages.empty()) {
+    // Les descripteurs sont copiés une fois dans les matrices, puis normalisés sur place.
+    FeatureMatrix trainRaw = run.trainDataset.getFeatureMatrix();
+    FeatureMatrix testRaw = testDataset.getFeatureMatrix();
+    if (trainRaw.empty() || testRaw.empty()) {
         cout << "Données insuffisantes pour la représentation : " << representationDir << ". Passé.\n";
-        return;
+        return false;
     }
 
-    // Normalisation
-    trainDataset.computeNormalizationBounds(trainImages);
-    trainDataset.normalizeDataset(trainImages);
-    trainDataset.normalizeDataset(testImages);
+    run.trainDataset.computeNormalizationBounds(trainRaw);
+    run.trainMatrix = run.trainDataset.normalizeMatrix(std::move(trainRaw));
+    run.testMatrix = run.trainDataset.normalizeMatrix(std::move(testRaw));
+    return true;
+}
 
-    // KNN
-    KNNClassifier knn(trainImages, 1, "euclidean");
-    ConfusionMatrix confusionMatrix(18);
+/**
+ * Entraîne les classifieurs d'une représentation et les évalue sur son ensemble de test.
+ * Les requêtes sont réparties sur le pool de threads par `evaluator` ; rien n'est affiché.
+ * Entrée :
+ *   - run (RepresentationRun&) : Données chargées ; reçoit les résultats.
+ *   - evaluator (ParallelEvaluator&) : Évaluateur parallèle.
+ * Sortie : Aucune.
+ */
+void evaluateRepresentation(RepresentationRun& run, const ParallelEvaluator& evaluator) {
+    // KNN (chaque tranche de requêtes est traitée en un seul lot)
+    KNNClassifier knn(run.trainMatrix, 1, "euclidean");
+    run.knn = evaluator.evaluate(run.testMatrix, 18, [&knn](const FeatureMatrix& queries) {
+        return knn.predictBatch(queries);
+    });
+
+    KNNClassifier knnWithFixedK(run.trainMatrix, 12, "euclidean");
+    run.knnWithFixedK = evaluator.evaluate(run.testMatrix, 18, [&knnWithFixedK](const FeatureMatrix& queries) {
+        return knnWithFixedK.predictBatch(queries);
+    });
 
-    for (const auto& testImage : testImages) {
-        int predictedLabel;
-        double confidenceScore;
-        tie(predictedLabel, confidenceScore) = knn.predictLabelWithConfidence(testImage);
-        confusionMatrix.addPrediction(testImage.getLabel(), predictedLabel);
-    }
+    // KMeans
+    KMeans kmeans(10, run.trainMatrix.dimension());
+    kmeans.fit(run.trainMatrix);
+    run.kmeans = evaluator.evaluate(run.testMatrix, 18, [&kmeans](const FeatureMatrix& queries) {
+        vector<pair<int, double>> predictions;
+        predictions.reserve(queries.rows());
+        for (size_t i = 0; i < queries.rows(); ++i) {
+            predictions.push_back(kmeans.predictLabelWithConfidence(queries.row(i), queries.dimension(),
+                                                                    queries.getRepresentationId()));
+        }
+        return predictions;
+    });
+}
 
-    string representationName = fs::path(representationDir).filename().string();
-    string confusionCSV = confusionDir + "/" + representationName + "_confusion_matrix.csv";
-    confusionMatrix.saveToCSV(confusionCSV);
+/**
+ * Sauvegarde les matrices de confusion, métriques et données PR d'une représentation.
+ */
+void saveRepresentation(RepresentationRun& run, const string& confusionDir, const string& metricsDir, const string& prDataDir) {
+    string confusionCSV = confusionDir + "/" + run.name + "_confusion_matrix.csv";
+    run.knn.confusionMatrix.saveToCSV(confusionCSV);
 
-    string metricsCSV = metricsDir + "/" + representationName + "_metrics.csv";
+    string metricsCSV = metricsDir + "/" + run.name + "_metrics.csv";
     Metrics::calculateMetricsFromCSV(confusionCSV, metricsCSV);
 
-    KNNClassifier knnWithFixedK(trainImages, 12, "euclidean");
-    vector<int> prTrueLabels;
-    vector<double> prConfidenceScores;
-
-    for (const auto& testImage : testImages) {
-        int predictedLabel;
-        double confidenceScore;
-        tie(predictedLabel, confidenceScore) = knnWithFixedK.predictLabelWithConfidence(testImage);
-        prTrueLabels.push_back(testImage.getLabel());
-        prConfidenceScores.push_back(confidenceScore);
-    }
+    string prFilename = prDataDir + "/" + run.name + "_pr_data.csv";
+    run.trainDataset.savePRData(prFilename, run.knnWithFixedK.trueLabels, run.knnWithFixedK.confidenceScores);
 
-    string prFilename = prDataDir + "/" + representationName + "_pr_data.csv";
-    trainDataset.savePRData(prFilename, prTrueLabels, prConfidenceScores);
+    string confusionCSVKMeans = confusionDir + "/" + run.name + "_KMeans_confusion_matrix.csv";
+    run.kmeans.confusionMatrix.saveToCSV(confusionCSVKMeans);
 
-    // KMeans
-    KMeans kmeans(10, 100, trainImages[0].getDescripteurs().size());
-    kmeans.fit(trainImages);
-
-    ConfusionMatrix confusionMatrixKMeans(18);
-    vector<int> prTrueLabelsKMeans;
-    vector<double> prConfidenceScoresKMeans;
-
-    for (const auto& testImage : testImages) {
-        int predictedLabel;
-        double confidenceScore;
-        tie(predictedLabel, confidenceScore) = kmeans.predictLabelWithConfidence(testImage);
-        confusionMatrixKMeans.addPrediction(testImage.getLabel(), predictedLabel);
-        prTrueLabelsKMeans.push_back(testImage.getLabel());
-        prConfidenceScoresKMeans.push_back(confidenceScore);
-    }
-
-    string confusionCSVKMeans = confusionDir + "/" + representationName + "_KMeans_confusion_matrix.csv";
-    confusionMatrixKMeans.saveToCSV(confusionCSVKMeans);
-
-    string metricsCSVKMeans = metricsDir + "/" + representationName + "_KMeans_metrics.csv";
+    string metricsCSVKMeans = metricsDir + "/" + run.name + "_KMeans_metrics.csv";
     Metrics::calculateMetricsFromCSV(confusionCSVKMeans, metricsCSVKMeans);
 
-    string prFilenameKMeans = prDataDir + "/" + representationName + "_KMeans_pr_data.csv";
-    trainDataset.savePRData(prFilenameKMeans, prTrueLabelsKMeans, prConfidenceScoresKMeans);
+    string prFilenameKMeans = prDataDir + "/" + run.name + "_KMeans_pr_data.csv";
+    run.trainDataset.savePRData(prFilenameKMeans, run.kmeans.trueLabels, run.kmeans.confidenceScores);
 
-    cout << "Traitement terminé pour : " << representationName << endl;
+    cout << "Traitement terminé pour : " << run.name << endl;
 }
 
 
@@ -160,8 +201,25 @@ int main(int argc, char* argv[]) {
     if (!fs::exists(metricsDir)) fs::create_directories(metricsDir);
     if (!fs::exists(prDataDir)) fs::create_directories(prDataDir);
 
+    // Chargement (séquentiel : chaque chargement lit déjà ses fichiers en parallèle).
+    vector<unique_ptr<RepresentationRun>> runs;
     for (const auto& representationDir : representationDirs) {
-        processRepresentation(representationDir, confusionDir, metricsDir, prDataDir);
+        auto run = make_unique<RepresentationRun>();
+        if (loadRepresentation(representationDir, *run)) {
+            runs.push_back(std::move(run));
+        }
+    }
+
+    // Évaluation : les représentations tournent en parallèle et chacune répartit ses requêtes
+    // sur le même pool.
+    ParallelEvaluator evaluator;
+    ThreadPool::shared().parallelFor(runs.size(), [&runs, &evaluator](size_t i, size_t) {
+        evaluateRepresentation(*runs[i], evaluator);
+    });
+
+    // Sauvegarde, dans l'ordre des représentations.
+    for (auto& run : runs) {
+        saveRepresentation(*run, confusionDir, metricsDir, prDataDir);
     }
 
     cout << "Toutes les matrices de confusion, métriques, et données PR ont été calculées et sauvegardées dans : " 
@@ -0,0 +1,126 @@
+#include "parallel/ThreadPool.h"
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+struct ThreadPool::Job {
+    const std::function<void(std::size_t, std::size_t)>* task;
+    std::size_t count;
+    std::size_t maxParticipants;
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> participants{1}; // L'appelant est le participant 0.
+    std::atomic<std::size_t> remaining{0};
+    std::mutex doneMutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+};
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+    : numWorkers(numThreads == 0 ? defaultThreadCount() : numThreads), stopping(false) {
+    for (std::size_t i = 1; i < numWorkers; ++i) {
+        helpers.emplace_back(&ThreadPool::helperLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+}
+
+std::size_t ThreadPool::defaultThreadCount() {
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool& ThreadPool::sequential() {
+    static ThreadPool pool(1);
+    return pool;
+}
+
+ThreadPool& ThreadPool::select(std::size_t numThreads, std::unique_ptr<ThreadPool>& owned) {
+    if (numThreads == 0) return shared();
+    if (numThreads == 1) return sequential();
+    if (!owned || owned->size() != numThreads) {
+        owned = std::make_unique<ThreadPool>(numThreads);
+    }
+    return *owned;
+}
+
+void ThreadPool::runJob(Job& job, std::size_t worker) {
+    std::size_t index;
+    while ((index = job.next.fetch_add(1)) < job.count) {
+        try {
+            (*job.task)(index, worker);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job.doneMutex);
+            if (!job.error) job.error = std::current_exception();
+        }
+        if (job.remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(job.doneMutex);
+            job.done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::helperLoop() {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        std::size_t worker = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (stopping) return;
+
+            job = jobs.front();
+            worker = job->participants.fetch_add(1);
+            // Plus de travail à distribuer ou plus de place : le job quitte la file.
+            if (worker + 1 >= job->maxParticipants || job->next.load() >= job->count) {
+                jobs.pop_front();
+            }
+            if (worker >= job->maxParticipants) continue;
+        }
+        runJob(*job, worker);
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& task) {
+    if (count == 0) return;
+    if (numWorkers == 1 || count == 1) {
+        for (std::size_t i = 0; i < count; ++i) task(i, 0);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->task = &task;
+    job->count = count;
+    job->maxParticipants = std::min(numWorkers, count);
+    job->remaining = count;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wakeUp.notify_all();
+
+    runJob(*job, 0);
+
+    {
+        std::unique_lock<std::mutex> lock(job->doneMutex);
+        job->done.wait(lock, [&job] { return job->remaining.load() == 0; });
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find(jobs.begin(), jobs.end(), job);
+        if (it != jobs.end()) jobs.erase(it);
+    }
+    if (job->error) std::rethrow_exception(job->error);
+}